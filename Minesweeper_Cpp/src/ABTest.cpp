@@ -0,0 +1,200 @@
+// ======================================================================
+// FILE:        ABTest.cpp
+//
+// DESCRIPTION: This file contains the A/B tournament. See ABTest.hpp.
+// ======================================================================
+
+#include "ABTest.hpp"
+#include "AgentComparison.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <random>
+#include <vector>
+
+namespace {
+
+// A world as WorldGenerator.py draws it, from its own seed
+void randomLayout(const ABOptions& options, unsigned seed, WorldLayout& layout)
+{
+    mt19937 rng(seed);
+    layout.rows = options.rows;
+    layout.cols = options.cols;
+    layout.startX = uniform_int_distribution<int>(0, options.cols - 1)(rng);
+    layout.startY = uniform_int_distribution<int>(0, options.rows - 1)(rng);
+    layout.mines.assign((size_t) options.rows * options.cols, 0);
+    uniform_int_distribution<int> square(0, options.rows * options.cols - 1);
+    for (int placed = 0; placed < options.mines; ) {
+        int i = square(rng);
+        int c = i / options.rows, r = i % options.rows;
+        if (!layout.mines[i] && (abs(c - layout.startX) > 1 || abs(r - layout.startY) > 1)) {
+            layout.mines[i] = 1;
+            ++placed;
+        }
+    }
+}
+
+// The z with a two-sided tail of 'alpha' under the standard normal
+double normalQuantile(double alpha)
+{
+    double low = 0, high = 40;
+    for (int i = 0; i < 200; ++i) {
+        double mid = (low + high) / 2;
+        if (erfc(mid / sqrt(2.0)) > alpha) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    return (low + high) / 2;
+}
+
+struct Pairs {
+    int games = 0;
+    int winsA = 0;
+    int winsB = 0;
+    int onlyA = 0;              // A won, B lost
+    int onlyB = 0;
+    int errorsA = 0;
+    int errorsB = 0;
+    vector<double> msA, msB;
+
+    // The difference in win rate, B's minus A's, and its interval at z
+    double delta() const { return (double) (onlyB - onlyA) / games; }
+    void interval(double z, double& low, double& high) const {
+        // Agresti-Min: half a pair added to each of the four cells
+        double n = games + 2;
+        double pA = (onlyA + 0.5) / n, pB = (onlyB + 0.5) / n;
+        double center = pB - pA;
+        double half = z * sqrt(max(pA + pB - center * center, 0.0) / n);
+        low = max(center - half, -1.0);
+        high = min(center + half, 1.0);
+    }
+};
+
+double quantile(vector<double> values, double q)
+{
+    if (values.empty()) {
+        return 0;
+    }
+    size_t k = min(values.size() - 1, (size_t) (q * values.size()));
+    nth_element(values.begin(), values.begin() + k, values.end());
+    return values[k];
+}
+
+void reportTimes(const string& label, const vector<double>& ms, ostream& out)
+{
+    double sum = 0;
+    for (double t : ms) {
+        sum += t;
+    }
+    out << left << setw(8) << label << right << fixed << setprecision(3)
+        << setw(11) << sum / max<size_t>(ms.size(), 1) << setw(11) << quantile(ms, 0.10)
+        << setw(11) << quantile(ms, 0.50) << setw(11) << quantile(ms, 0.90)
+        << setw(11) << quantile(ms, 0.99) << setw(11) << *max_element(ms.begin(), ms.end()) << endl;
+}
+
+}
+
+bool runABTest(const string& a, const string& b, const ABOptions& options, const WorldOptions& worldOptions,
+               const map<string, string>& longOptions, ostream& out)
+{
+    if (options.rows < 4 || options.cols < 4 || options.mines < 1 || options.mines > options.rows * options.cols - 9
+        || options.maxGames < 1 || options.check < 1 || options.confidence <= 0 || options.confidence >= 1
+        || options.margin < 0) {
+        return false;
+    }
+
+    ComparedAgent agents[2];
+    const string specs[2] = { a, b };
+    for (int k = 0; k < 2; ++k) {
+        string error;
+        if (!agents[k].load(specs[k], longOptions, error)) {
+            out << "[ERROR] Failed to load agent plugin " << specs[k] << ": " << error << endl;
+            return false;
+        }
+    }
+
+    int looks = (options.maxGames + options.check - 1) / options.check;
+    double z = normalQuantile((1 - options.confidence) / looks);
+    out << "A: " << agents[0].name << endl << "B: " << agents[1].name << endl;
+    out << options.rows << "x" << options.cols << ":" << options.mines << " worlds from seed " << options.seed
+        << "; up to " << options.maxGames << " worlds, a look every " << options.check << " (z = "
+        << fixed << setprecision(3) << z << " per look)" << endl;
+    out << right << setw(8) << "worlds" << setw(8) << "A wins" << setw(8) << "B wins" << setw(8) << "A only"
+        << setw(8) << "B only" << setw(10) << "B - A %" << setw(20) << "interval %" << endl;
+
+    Pairs pairs;
+    WorldLayout layout;
+    string verdict;
+    double low = 0, high = 0;
+    while (pairs.games < options.maxGames && verdict.empty()) {
+        unsigned seed = options.seed + pairs.games;
+        randomLayout(options, seed, layout);
+        string name = "AB_world_" + to_string(seed);
+        bool won[2];
+        for (int k = 0; k < 2; ++k) {
+            if (!agents[k].play(layout, name, worldOptions)) {
+                ++(k ? pairs.errorsB : pairs.errorsA);
+            }
+            won[k] = agents[k].score > 0;
+            (k ? pairs.msB : pairs.msA).push_back(agents[k].ms);
+        }
+        ++pairs.games;
+        pairs.winsA += won[0];
+        pairs.winsB += won[1];
+        pairs.onlyA += won[0] && !won[1];
+        pairs.onlyB += won[1] && !won[0];
+
+        if (pairs.games % options.check && pairs.games < options.maxGames) {
+            continue;
+        }
+        pairs.interval(z, low, high);
+        out << setw(8) << pairs.games << setw(8) << pairs.winsA << setw(8) << pairs.winsB << setw(8) << pairs.onlyA
+            << setw(8) << pairs.onlyB << fixed << setprecision(2) << setw(10) << 100 * pairs.delta()
+            << setw(11) << "[" << setw(6) << 100 * low << ", " << setw(6) << 100 * high << "]" << endl;
+        if (low > 0) {
+            verdict = "B wins more often than A";
+        } else if (high < 0) {
+            verdict = "A wins more often than B";
+        } else if (low >= -options.margin && high <= options.margin) {
+            verdict = "no difference beyond +-" + to_string(100 * options.margin).substr(0, 4) + "%";
+        }
+    }
+    if (verdict.empty()) {
+        verdict = "inconclusive";
+    }
+    out << "Result: " << verdict << " at " << setprecision(1) << 100 * options.confidence << "% confidence, after "
+        << pairs.games << " worlds" << (pairs.games < options.maxGames ? " (stopped early)" : "") << endl;
+    if (pairs.errorsA || pairs.errorsB) {
+        out << "Games that threw: A " << pairs.errorsA << ", B " << pairs.errorsB << endl;
+    }
+
+    vector<double> difference(pairs.games);
+    int faster = 0;
+    for (int n = 0; n < pairs.games; ++n) {
+        difference[n] = pairs.msB[n] - pairs.msA[n];
+        faster += difference[n] < 0;
+    }
+    out << endl << "Time per game (ms)" << endl;
+    out << left << setw(8) << "" << right << setw(11) << "mean" << setw(11) << "p10" << setw(11) << "p50"
+        << setw(11) << "p90" << setw(11) << "p99" << setw(11) << "max" << endl;
+    reportTimes("A", pairs.msA, out);
+    reportTimes("B", pairs.msB, out);
+    reportTimes("B - A", difference, out);
+
+    double mean = 0, spread = 0;
+    for (double d : difference) {
+        mean += d;
+    }
+    mean /= pairs.games;
+    for (double d : difference) {
+        spread += (d - mean) * (d - mean);
+    }
+    double half = pairs.games > 1
+        ? normalQuantile(1 - options.confidence) * sqrt(spread / (pairs.games - 1) / pairs.games) : 0;
+    out << "Mean B - A: " << setprecision(3) << mean << " ms, " << setprecision(1) << 100 * options.confidence
+        << "% interval [" << setprecision(3) << mean - half << ", " << mean + half << "]; B faster on "
+        << faster << " of " << pairs.games << " worlds" << endl;
+    return true;
+}
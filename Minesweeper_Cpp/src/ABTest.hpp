@@ -0,0 +1,64 @@
+// ======================================================================
+// FILE:        ABTest.hpp
+//
+// DESCRIPTION: This file contains the A/B tournament: two agents play
+//              the same seeded random worlds, and their paired results
+//              say whether B wins more or less often than A, with a
+//              confidence interval, and how their game times compare.
+//
+// NOTES:       - An agent is MyAI, randomAI or the path of an agent
+//                plugin, as for the side-by-side run (see
+//                AgentComparison.hpp).
+//
+//              - World n is drawn from its own generator, seeded with
+//                seed + n, as WorldGenerator.py draws worlds: a random
+//                start and the mines uniformly placed outside the 3x3
+//                patch around it. Both agents play it from that start,
+//                so every world gives a pair of outcomes and the noise of
+//                the worlds themselves cancels out of the difference.
+//
+//              - The win rate difference is B's minus A's. Its interval
+//                is the Agresti-Min interval for paired proportions: a
+//                Wald interval over the pairs after adding half a pair to
+//                each of the four outcome cells, which stays sensible
+//                when the agents rarely disagree.
+//
+//              - The tournament looks at the results every 'check' worlds
+//                and stops at the first look where the interval excludes
+//                zero (one agent wins more) or lies within +-margin (no
+//                difference that matters). Looking repeatedly would make
+//                a false call likelier than 1 - confidence, so each look
+//                uses the confidence left after splitting 1 - confidence
+//                evenly over all the looks the game limit allows
+//                (Bonferroni): conservative, but valid however early it
+//                stops.
+//
+//              - Game times are reported as distributions for each agent
+//                and for the per-world difference B - A; times don't take
+//                part in the stopping rule.
+// ======================================================================
+
+#ifndef MINE_SWEEPER_CPP_SHELL_ABTEST_HPP
+#define MINE_SWEEPER_CPP_SHELL_ABTEST_HPP
+
+#include "World.hpp"
+#include <map>
+
+struct ABOptions {
+    int rows = 16;
+    int cols = 30;
+    int mines = 99;
+    int maxGames = 2000;        // worlds played if no look stops the run
+    int check = 100;            // worlds between looks
+    double confidence = 0.95;   // of the whole run, over all its looks
+    double margin = 0.01;       // equivalence margin on the win rate; 0 never stops for it
+    unsigned seed = 0;
+};
+
+// Plays agents 'a' and 'b' against each other and reports the result.
+// Plugins are configured with 'longOptions'. Returns false if the options
+// are invalid or a plugin can't be loaded.
+bool runABTest ( const string& a, const string& b, const ABOptions& options, const WorldOptions& worldOptions,
+                 const map<string, string>& longOptions, ostream& out );
+
+#endif //MINE_SWEEPER_CPP_SHELL_ABTEST_HPP
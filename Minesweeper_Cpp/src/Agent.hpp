@@ -23,6 +23,8 @@
 #ifndef MINE_SWEEPER_CPP_SHELL_AGENT_HPP
 #define MINE_SWEEPER_CPP_SHELL_AGENT_HPP
 
+#include <vector>
+
 class Agent {
 
 public:
@@ -53,6 +55,48 @@ public:
                 (
                     int number
                 ) = 0;
+
+        // Optional batch interface. An agent that supports it is given the
+        // percepts of every action World applied from its last batch (the
+        // number uncovered, or -1, in order) and answers with one or more
+        // actions. World applies them in order and stops at the first one
+        // that ends the game. The default answers one action at a time
+        // through getAction.
+        virtual bool supportsBatch () const { return false; }
+
+        virtual void getActions
+                (
+                    const std::vector<int>& percepts,
+                    std::vector<Action>&    actions
+                )
+        {
+            actions.push_back( getAction( percepts.empty() ? -1 : percepts.back() ) );
+        }
+
+        // Optional cascade interface. In cascade mode, uncovering a zero
+        // makes World uncover the whole zero region and its numbered
+        // border in the same move. An agent that supports it is handed
+        // those extra squares, with their numbers, in one call before its
+        // next getAction/getActions. World only cascades for such agents.
+        struct Reveal{
+            int             x;
+            int             y;
+            int             number;
+        };
+
+        virtual bool supportsCascade () const { return false; }
+
+        virtual void revealed ( const std::vector<Reveal>& /*squares*/ ) {}
+
+        // Optional statistics for results logs and benchmarks, -1 if the
+        // agent doesn't keep track: the largest frontier (covered squares
+        // next to a number) it reasoned about this game, and the nodes its
+        // searches visited this game
+        virtual int peakFrontier () const { return -1; }
+        virtual long long searchNodes () const { return -1; }
+
+        // Agents are owned and deleted through Agent*
+        virtual ~Agent() {}
         };
 
 #endif //MINE_SWEEPER_CPP_SHELL_AGENT_HPP
@@ -0,0 +1,165 @@
+// ======================================================================
+// FILE:        AgentComparison.cpp
+//
+// DESCRIPTION: This file contains the side-by-side agent run. See
+//              AgentComparison.hpp.
+// ======================================================================
+
+#include "AgentComparison.hpp"
+#include <algorithm>
+#include <chrono>
+#include <dirent.h>
+#include <iomanip>
+
+ComparedAgent::~ComparedAgent()
+{
+    // the World goes before the plugin that made its agent
+    delete world;
+    delete plugin;
+}
+
+bool ComparedAgent::load(const string& spec, const map<string, string>& longOptions, string& error)
+{
+    if (spec == "MyAI" || spec == "randomAI") {
+        name = spec;
+        aiType = spec;
+        return true;
+    }
+    plugin = new AgentPlugin;
+    if (!plugin->load(spec, error)) {
+        return false;
+    }
+    for (const auto& option : longOptions) {
+        plugin->configure(option.first, option.second);
+    }
+    name = plugin->name + " (" + spec + ")";
+    return true;
+}
+
+bool ComparedAgent::play(const WorldLayout& layout, const string& worldName, const WorldOptions& options)
+{
+    WorldOptions own = options;
+    own.plugin = plugin;
+    own.trace = nullptr;
+
+    bool played = true;
+    score = 0;
+    moves = 0;
+    auto start = chrono::steady_clock::now();
+    try {
+        if (world) {
+            world->reset(layout, worldName);
+        } else {
+            world = new World(false, aiType, layout, worldName, own);
+        }
+        score = world->run();
+        moves = world->moves();
+    }
+    catch (...) {
+        // as in a folder run, the next world starts from a fresh World
+        played = false;
+        delete world;
+        world = nullptr;
+    }
+    ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    return played;
+}
+
+namespace {
+
+struct Tally {
+    int games = 0;
+    int wins = 0;
+    int errors = 0;
+    long long score = 0;
+    long long moves = 0;
+    double ms = 0;
+    double maxMs = 0;
+};
+
+bool listWorlds(const string& folder, vector<string>& names)
+{
+    DIR* dir = opendir(folder.c_str());
+    if (!dir) {
+        return false;
+    }
+    while (struct dirent* ent = readdir(dir)) {
+        if (ent->d_name[0] != '.') {
+            names.push_back(ent->d_name);
+        }
+    }
+    closedir(dir);
+    sort(names.begin(), names.end());
+    return true;
+}
+
+void report(const vector<ComparedAgent>& agents, const vector<Tally>& tallies, int worlds, int unreadable, ostream& out)
+{
+    size_t width = 6;
+    for (const ComparedAgent& agent : agents) {
+        width = max(width, agent.name.size() + 2);
+    }
+    out << left << setw(width) << "agent" << right << setw(8) << "games" << setw(8) << "wins"
+        << setw(9) << "win %" << setw(8) << "score" << setw(12) << "moves/game"
+        << setw(11) << "ms/game" << setw(11) << "max ms" << setw(8) << "errors" << endl;
+    for (size_t a = 0; a < agents.size(); ++a) {
+        const Tally& t = tallies[a];
+        double games = max(t.games, 1);
+        out << left << setw(width) << agents[a].name << right << setw(8) << t.games << setw(8) << t.wins
+            << fixed << setprecision(2) << setw(9) << 100.0 * t.wins / games << setw(8) << t.score
+            << setprecision(1) << setw(12) << t.moves / games
+            << setprecision(3) << setw(11) << t.ms / games << setw(11) << t.maxMs << setw(8) << t.errors << endl;
+    }
+    out << "World files read: " << worlds << " (once for all " << agents.size() << " agents)";
+    if (unreadable) {
+        out << ", " << unreadable << " unreadable";
+    }
+    out << endl;
+}
+
+}
+
+bool compareAgents(const string& folder, const vector<string>& specs, const WorldOptions& options,
+                   const map<string, string>& longOptions, ostream& out)
+{
+    vector<ComparedAgent> agents(specs.size());
+    for (size_t a = 0; a < specs.size(); ++a) {
+        string error;
+        if (!agents[a].load(specs[a], longOptions, error)) {
+            out << "[ERROR] Failed to load agent plugin " << specs[a] << ": " << error << endl;
+            return false;
+        }
+    }
+
+    vector<string> names;
+    if (!listWorlds(folder, names)) {
+        out << "[ERROR] Failed to open directory." << endl;
+        return false;
+    }
+
+    vector<Tally> tallies(agents.size());
+    int worlds = 0, unreadable = 0;
+    WorldLayout layout;
+    for (const string& name : names) {
+        if (!layout.load(folder + "/" + name)) {
+            ++unreadable;
+            continue;
+        }
+        ++worlds;
+        for (size_t a = 0; a < agents.size(); ++a) {
+            ComparedAgent& agent = agents[a];
+            Tally& t = tallies[a];
+            if (!agent.play(layout, name, options)) {
+                ++t.errors;
+            }
+            ++t.games;
+            t.wins += agent.score > 0;
+            t.score += agent.score;
+            t.moves += agent.moves;
+            t.ms += agent.ms;
+            t.maxMs = max(t.maxMs, agent.ms);
+        }
+    }
+    report(agents, tallies, worlds, unreadable, out);
+    return true;
+}
@@ -0,0 +1,61 @@
+// ======================================================================
+// FILE:        AgentComparison.hpp
+//
+// DESCRIPTION: This file contains the side-by-side agent run: several
+//              agents play every world of a folder in one process, and
+//              their results are reported in one table.
+//
+// NOTES:       - An agent is MyAI or randomAI (the built-in agents) or
+//                the path of an agent plugin (see AgentPlugin.hpp). Each
+//                plugin is configured with every long option of the run.
+//
+//              - Every world file is read once, into a WorldLayout, and
+//                each agent's World is reset from it, so comparing N
+//                builds costs one world load per world instead of N.
+//
+//              - Worlds are played in file name order, every agent on
+//                one world before the next world. Games are not traced.
+// ======================================================================
+
+#ifndef MINE_SWEEPER_CPP_SHELL_AGENTCOMPARISON_HPP
+#define MINE_SWEEPER_CPP_SHELL_AGENTCOMPARISON_HPP
+
+#include "World.hpp"
+#include <map>
+#include <vector>
+
+// One agent of a comparison, playing in its own World
+class ComparedAgent
+{
+public:
+    ~ComparedAgent();
+
+    // Loads MyAI, randomAI or the plugin at the path 'spec', configuring
+    // a plugin with 'longOptions'. Returns false, with the reason in
+    // 'error', if the plugin can't be loaded.
+    bool load ( const string& spec, const map<string, string>& longOptions, string& error );
+
+    // Plays one world. Returns false if the game threw; the next world
+    // then starts from a fresh World.
+    bool play ( const WorldLayout& layout, const string& name, const WorldOptions& options );
+
+    string name;
+
+    // the last game played
+    int score = 0;
+    int moves = 0;
+    double ms = 0;
+
+private:
+    string aiType = "MyAI";             // for the built-in agents
+    AgentPlugin* plugin = nullptr;
+    World* world = nullptr;
+};
+
+// Plays every world in 'folder' with each of 'agents' and reports them
+// side by side. Returns false if a plugin can't be loaded or the folder
+// can't be read.
+bool compareAgents ( const string& folder, const vector<string>& agents, const WorldOptions& options,
+                     const map<string, string>& longOptions, ostream& out );
+
+#endif //MINE_SWEEPER_CPP_SHELL_AGENTCOMPARISON_HPP
@@ -0,0 +1,74 @@
+// ======================================================================
+// FILE:        AgentPlugin.cpp
+//
+// DESCRIPTION: This file contains the agent plugin loader. See
+//              AgentPlugin.hpp.
+// ======================================================================
+
+#include "AgentPlugin.hpp"
+#include <dlfcn.h>
+
+AgentPlugin::~AgentPlugin()
+{
+    if (handle) {
+        dlclose(handle);
+    }
+}
+
+bool AgentPlugin::load(const string& _path, string& error)
+{
+    path = _path;
+    // a bare file name would make dlopen search the library path
+    string file = path.find('/') == string::npos ? "./" + path : path;
+    // RTLD_LOCAL keeps two builds of the same agent from sharing symbols
+    handle = dlopen(file.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!handle) {
+        error = dlerror();
+        return false;
+    }
+
+    AgentPluginAbiFn abi = (AgentPluginAbiFn) dlsym(handle, "minesweeper_agent_abi");
+    AgentPluginNameFn nameFn = (AgentPluginNameFn) dlsym(handle, "minesweeper_agent_name");
+    createFn = (AgentPluginCreateFn) dlsym(handle, "minesweeper_agent_create");
+    destroyFn = (AgentPluginDestroyFn) dlsym(handle, "minesweeper_agent_destroy");
+    resetFn = (AgentPluginResetFn) dlsym(handle, "minesweeper_agent_reset");
+    configureFn = (AgentPluginConfigureFn) dlsym(handle, "minesweeper_agent_configure");
+    if (!abi || !nameFn || !createFn || !destroyFn) {
+        error = "not an agent plugin (missing minesweeper_agent_* exports)";
+        return false;
+    }
+    if (abi() != AGENT_PLUGIN_ABI) {
+        error = "built for agent ABI " + to_string(abi()) + ", this build is " + to_string(AGENT_PLUGIN_ABI);
+        return false;
+    }
+    name = nameFn();
+    return true;
+}
+
+void AgentPlugin::configure(const string& name, const string& value) const
+{
+    if (configureFn) {
+        configureFn(name.c_str(), value.c_str());
+    }
+}
+
+Agent* AgentPlugin::create(int rows, int cols, int mines, int startX, int startY) const
+{
+    return createFn(rows, cols, mines, startX, startY);
+}
+
+void AgentPlugin::destroy(Agent* agent) const
+{
+    if (agent) {
+        destroyFn(agent);
+    }
+}
+
+void AgentPlugin::reset(Agent*& agent, int rows, int cols, int mines, int startX, int startY) const
+{
+    if (agent && resetFn && resetFn(agent, rows, cols, mines, startX, startY)) {
+        return;
+    }
+    destroy(agent);
+    agent = create(rows, cols, mines, startX, startY);
+}
@@ -0,0 +1,100 @@
+// ======================================================================
+// FILE:        AgentPlugin.hpp
+//
+// DESCRIPTION: This file contains agent plugins: agents built into a
+//              shared library and loaded at run time, so several solver
+//              builds can play in one process (see Main's --agents).
+//
+// NOTES:       - A plugin exports a small C ABI:
+//
+//                  int         minesweeper_agent_abi ()
+//                  const char* minesweeper_agent_name ()
+//                  Agent*      minesweeper_agent_create (rows, cols,
+//                                  mines, startX, startY)
+//                  void        minesweeper_agent_destroy (Agent*)
+//
+//                and optionally
+//
+//                  int         minesweeper_agent_reset (Agent*, rows,
+//                                  cols, mines, startX, startY)
+//                  void        minesweeper_agent_configure (name, value)
+//
+//                reset starts a new game on an existing agent and returns
+//                0 if it can't (the agent is then destroyed and created
+//                again). configure is handed every long option of the run
+//                (name without the dashes), so a plugin can load the same
+//                pattern table or turn on the same features as the host.
+//
+//              - The agent is a C++ object behind the C factory, so the
+//                plugin must be built against this Agent.hpp with the same
+//                compiler. minesweeper_agent_abi returns AGENT_PLUGIN_ABI
+//                as the plugin saw it; a mismatch refuses to load. Bump it
+//                whenever Agent changes.
+//
+//              - Build plugins with -fvisibility=hidden so only the C ABI
+//                is exported: each plugin then keeps its own copy of the
+//                solver and of its shared tables (pattern table, component
+//                cache, profiler), and two builds of MyAI can't call into
+//                each other. MINESWEEPER_AGENT_PLUGIN defines the required
+//                exports for an agent class; 'make plugin' builds MyAI as
+//                bin/MyAI.so from MyAIPlugin.cpp.
+// ======================================================================
+
+#ifndef MINE_SWEEPER_CPP_SHELL_AGENTPLUGIN_HPP
+#define MINE_SWEEPER_CPP_SHELL_AGENTPLUGIN_HPP
+
+#include "Agent.hpp"
+#include <string>
+
+using namespace std;
+
+#define AGENT_PLUGIN_ABI 1
+
+#define AGENT_PLUGIN_EXPORT extern "C" __attribute__((visibility("default")))
+
+// The required exports of a plugin whose agent is AgentClass
+#define MINESWEEPER_AGENT_PLUGIN(AgentClass, agentName) \
+    AGENT_PLUGIN_EXPORT int minesweeper_agent_abi() { return AGENT_PLUGIN_ABI; } \
+    AGENT_PLUGIN_EXPORT const char* minesweeper_agent_name() { return agentName; } \
+    AGENT_PLUGIN_EXPORT Agent* minesweeper_agent_create(int rows, int cols, int mines, int startX, int startY) \
+        { return new AgentClass(rows, cols, mines, startX, startY); } \
+    AGENT_PLUGIN_EXPORT void minesweeper_agent_destroy(Agent* agent) { delete agent; }
+
+extern "C" {
+typedef int         (*AgentPluginAbiFn)         ();
+typedef const char* (*AgentPluginNameFn)        ();
+typedef Agent*      (*AgentPluginCreateFn)      ( int rows, int cols, int mines, int startX, int startY );
+typedef void        (*AgentPluginDestroyFn)     ( Agent* agent );
+typedef int         (*AgentPluginResetFn)       ( Agent* agent, int rows, int cols, int mines, int startX, int startY );
+typedef void        (*AgentPluginConfigureFn)   ( const char* name, const char* value );
+}
+
+class AgentPlugin
+{
+public:
+    ~AgentPlugin();
+
+    // Loads the library at 'path'. Returns false, with the reason in
+    // 'error', if it can't be opened or lacks a required export.
+    bool load ( const string& path, string& error );
+
+    void configure ( const string& name, const string& value ) const;
+
+    Agent* create ( int rows, int cols, int mines, int startX, int startY ) const;
+    void destroy ( Agent* agent ) const;
+
+    // Starts a new game on agent, or replaces it if the plugin can't
+    void reset ( Agent*& agent, int rows, int cols, int mines, int startX, int startY ) const;
+
+    string name;        // the plugin's own name for its agent
+    string path;
+
+private:
+    void* handle = nullptr;
+    AgentPluginCreateFn     createFn = nullptr;
+    AgentPluginDestroyFn    destroyFn = nullptr;
+    AgentPluginResetFn      resetFn = nullptr;
+    AgentPluginConfigureFn  configureFn = nullptr;
+};
+
+#endif //MINE_SWEEPER_CPP_SHELL_AGENTPLUGIN_HPP
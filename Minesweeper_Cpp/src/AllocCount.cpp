@@ -0,0 +1,115 @@
+// ======================================================================
+// FILE:        AllocCount.cpp
+//
+// DESCRIPTION: This file contains the counting global operator new and
+//              delete behind the profiler's allocation counts (see
+//              Profiler.hpp).
+//
+// NOTES:       - Every replaceable form is replaced, all on malloc and
+//                free, so memory is never allocated by one allocator and
+//                freed by the other (sanitizers report the mix).
+//
+//              - Counting costs one flag test until the profiler is
+//                enabled.
+//
+//              - Only the Minesweeper binary links this file: a plugin or
+//                a library loaded into another process must not replace
+//                that process's allocator.
+// ======================================================================
+
+#include "Profiler.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+struct Linked {
+    Linked() { profile_alloc_linked = true; }
+} linked;
+
+void* allocate(size_t size)
+{
+    if (profile_alloc_counting) {
+        ++profile_alloc_count;
+        profile_alloc_bytes += size;
+    }
+    void* p;
+    while (!(p = malloc(size ? size : 1))) {
+        new_handler handler = get_new_handler();
+        if (!handler) {
+            throw bad_alloc();
+        }
+        handler();
+    }
+    return p;
+}
+
+void* allocate(size_t size, const nothrow_t&) noexcept
+{
+    try {
+        return allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+}
+
+void* operator new(size_t size) { return allocate(size); }
+void* operator new[](size_t size) { return allocate(size); }
+void* operator new(size_t size, const nothrow_t& tag) noexcept { return allocate(size, tag); }
+void* operator new[](size_t size, const nothrow_t& tag) noexcept { return allocate(size, tag); }
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, const nothrow_t&) noexcept { free(p); }
+void operator delete[](void* p, const nothrow_t&) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+#if __cplusplus >= 201703L
+// aligned forms; C++11 code never calls them, but a newer standard does
+namespace {
+
+void* allocateAligned(size_t size, align_val_t align)
+{
+    if (profile_alloc_counting) {
+        ++profile_alloc_count;
+        profile_alloc_bytes += size;
+    }
+    size_t alignment = max((size_t) align, sizeof(void*));
+    void* p;
+    while (posix_memalign(&p, alignment, size ? size : 1)) {
+        new_handler handler = get_new_handler();
+        if (!handler) {
+            throw bad_alloc();
+        }
+        handler();
+    }
+    return p;
+}
+
+}
+
+void* operator new(size_t size, align_val_t align) { return allocateAligned(size, align); }
+void* operator new[](size_t size, align_val_t align) { return allocateAligned(size, align); }
+void* operator new(size_t size, align_val_t align, const nothrow_t&) noexcept
+{
+    try {
+        return allocateAligned(size, align);
+    } catch (...) {
+        return nullptr;
+    }
+}
+void* operator new[](size_t size, align_val_t align, const nothrow_t& tag) noexcept
+{
+    return operator new(size, align, tag);
+}
+void operator delete(void* p, align_val_t) noexcept { free(p); }
+void operator delete[](void* p, align_val_t) noexcept { free(p); }
+void operator delete(void* p, size_t, align_val_t) noexcept { free(p); }
+void operator delete[](void* p, size_t, align_val_t) noexcept { free(p); }
+void operator delete(void* p, align_val_t, const nothrow_t&) noexcept { free(p); }
+void operator delete[](void* p, align_val_t, const nothrow_t&) noexcept { free(p); }
+#endif
@@ -0,0 +1,249 @@
+// ======================================================================
+// FILE:        BitSlice.cpp
+//
+// DESCRIPTION: This file contains the bit-sliced brute force. See
+//              BitSlice.hpp.
+// ======================================================================
+
+#include "BitSlice.hpp"
+#include <cstdint>
+#include <immintrin.h>
+
+// Mines a number can have among its squares (8 neighbors), plus one
+#define BITSLICE_COUNTS 9
+
+namespace {
+
+// Lane l of a kernel word w is assignment w * 64 + l
+uint64_t lanePattern(int cell, int w)
+{
+    static const uint64_t low[6] = {
+        0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+        0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL
+    };
+    return cell < 6 ? low[cell] : (w >> (cell - 6) & 1) ? ~0ULL : 0;
+}
+
+struct SliceTables {
+    int words;                          // 1 (64 lanes) or 4 (256 lanes)
+    int low;                            // squares within the lanes
+    int high;                           // squares constant per block
+    vector<uint64_t> pattern;           // [cell * words + w], low squares
+    vector<uint64_t> base;              // lanes meeting the numbers with no high squares
+    vector<uint64_t> range;             // [(j * BITSLICE_COUNTS + h) * words + w]: lanes
+                                        // meeting numbers[j] when h of its high squares are mines
+    vector<vector<int>> cell_numbers;   // numbers touching each high square
+    vector<vector<int>> closing;        // numbers whose last high square each is
+    size_t numbers;                     // numbers with high squares
+};
+
+void buildTables(const FrontierComponent& comp, int words, SliceTables& t)
+{
+    int n = comp.cells.size();
+    t.words = words;
+    t.low = min(n, words == 4 ? 8 : 6);
+    t.high = n - t.low;
+    t.pattern.resize(t.low * words);
+    for (int i = 0; i < t.low; ++i) {
+        for (int w = 0; w < words; ++w) {
+            t.pattern[i * words + w] = lanePattern(i, w);
+        }
+    }
+
+    // lanes past the last assignment of a tiny component are never valid
+    t.base.assign(words, 0);
+    for (int w = 0; w < words; ++w) {
+        for (int l = 0; l < 64; ++l) {
+            if (w * 64 + l < (1 << t.low)) {
+                t.base[w] |= 1ULL << l;
+            }
+        }
+    }
+
+    t.range.clear();
+    t.cell_numbers.assign(t.high, vector<int>());
+    t.closing.assign(t.high, vector<int>());
+    t.numbers = 0;
+    uint64_t plane[4][4], mask[4];
+    for (const Constraint& constraint : comp.constraints) {
+        // ripple-carry adds of the low squares into 4 bit planes
+        int lowCells = 0, highCells = 0;
+        for (int p = 0; p < 4; ++p) {
+            for (int w = 0; w < words; ++w) {
+                plane[p][w] = 0;
+            }
+        }
+        for (int cell : constraint.cells) {
+            if (cell >= t.low) {
+                ++highCells;
+                continue;
+            }
+            ++lowCells;
+            for (int w = 0; w < words; ++w) {
+                uint64_t carry = t.pattern[cell * words + w];
+                for (int p = 0; p < 4 && carry; ++p) {
+                    uint64_t next = plane[p][w] & carry;
+                    plane[p][w] ^= carry;
+                    carry = next;
+                }
+            }
+        }
+
+        size_t at = t.range.size();
+        if (highCells) {
+            t.range.resize(at + BITSLICE_COUNTS * words, 0);
+        }
+        for (int h = 0; h <= highCells; ++h) {
+            // met when mines - slack <= low + h <= mines
+            int from = max(constraint.mines - constraint.slack - h, 0);
+            int to = min(constraint.mines - h, lowCells);
+            for (int w = 0; w < words; ++w) {
+                mask[w] = 0;
+            }
+            for (int count = from; count <= to; ++count) {
+                for (int w = 0; w < words; ++w) {
+                    uint64_t equal = ~0ULL;
+                    for (int p = 0; p < 4; ++p) {
+                        equal &= (count >> p & 1) ? plane[p][w] : ~plane[p][w];
+                    }
+                    mask[w] |= equal;
+                }
+            }
+            for (int w = 0; w < words; ++w) {
+                if (highCells) {
+                    t.range[at + h * words + w] = mask[w];
+                } else {
+                    t.base[w] &= mask[w];
+                }
+            }
+        }
+        if (highCells) {
+            int last = 0;
+            for (int cell : constraint.cells) {
+                if (cell >= t.low) {
+                    t.cell_numbers[cell - t.low].push_back(t.numbers);
+                    last = max(last, cell - t.low);
+                }
+            }
+            t.closing[last].push_back(t.numbers);
+            ++t.numbers;
+        }
+    }
+}
+
+// Depth-first over the high squares. A number's mask is applied once its
+// last high square is set, and a branch with no valid lane left is cut.
+struct SliceSearch {
+    const SliceTables& t;
+    vector<int> high_mines;             // high mines set so far, per number
+    vector<uint64_t>& mines;
+
+    SliceSearch(const SliceTables& tables, vector<uint64_t>& counts)
+        : t(tables), high_mines(tables.numbers, 0), mines(counts) {}
+
+    void set(int level, int mine)
+    {
+        for (int j : t.cell_numbers[level]) {
+            high_mines[j] += mine;
+        }
+    }
+};
+
+// Valid lanes under this branch; adds the branch's mines to the counts
+uint64_t descend64(SliceSearch& search, int level, uint64_t valid)
+{
+    const SliceTables& t = search.t;
+    if (level == t.high) {
+        for (int i = 0; i < t.low; ++i) {
+            search.mines[i] += __builtin_popcountll(valid & t.pattern[i]);
+        }
+        return __builtin_popcountll(valid);
+    }
+    uint64_t lanes = 0;
+    for (int mine = 0; mine <= 1; ++mine) {
+        search.set(level, mine);
+        uint64_t branch = valid;
+        for (size_t k = 0; branch && k < t.closing[level].size(); ++k) {
+            int j = t.closing[level][k];
+            branch &= t.range[j * BITSLICE_COUNTS + search.high_mines[j]];
+        }
+        if (branch) {
+            uint64_t sub = descend64(search, level + 1, branch);
+            search.mines[t.low + level] += mine ? sub : 0;
+            lanes += sub;
+        }
+        search.set(level, -mine);
+    }
+    return lanes;
+}
+
+__attribute__((target("avx2,popcnt")))
+int popcount256(__m256i v)
+{
+    return __builtin_popcountll(_mm256_extract_epi64(v, 0)) + __builtin_popcountll(_mm256_extract_epi64(v, 1))
+         + __builtin_popcountll(_mm256_extract_epi64(v, 2)) + __builtin_popcountll(_mm256_extract_epi64(v, 3));
+}
+
+__attribute__((target("avx2,popcnt")))
+uint64_t descend256(SliceSearch& search, int level, __m256i valid)
+{
+    const SliceTables& t = search.t;
+    const __m256i* range = (const __m256i*) t.range.data();
+    if (level == t.high) {
+        const __m256i* pattern = (const __m256i*) t.pattern.data();
+        for (int i = 0; i < t.low; ++i) {
+            search.mines[i] += popcount256(_mm256_and_si256(valid, _mm256_loadu_si256(pattern + i)));
+        }
+        return popcount256(valid);
+    }
+    uint64_t lanes = 0;
+    for (int mine = 0; mine <= 1; ++mine) {
+        search.set(level, mine);
+        __m256i branch = valid;
+        bool any = true;
+        for (size_t k = 0; any && k < t.closing[level].size(); ++k) {
+            int j = t.closing[level][k];
+            branch = _mm256_and_si256(branch, _mm256_loadu_si256(range + j * BITSLICE_COUNTS + search.high_mines[j]));
+            any = !_mm256_testz_si256(branch, branch);
+        }
+        if (any) {
+            uint64_t sub = descend256(search, level + 1, branch);
+            search.mines[t.low + level] += mine ? sub : 0;
+            lanes += sub;
+        }
+        search.set(level, -mine);
+    }
+    return lanes;
+}
+
+__attribute__((target("avx2,popcnt")))
+uint64_t count256(SliceSearch& search)
+{
+    __m256i base = _mm256_loadu_si256((const __m256i*) search.t.base.data());
+    return _mm256_testz_si256(base, base) ? 0 : descend256(search, 0, base);
+}
+
+}
+
+bool bitSliceWide()
+{
+    static const bool wide = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+    return wide;
+}
+
+void bitSliceCount(const FrontierComponent& comp, ComponentSolution& solution, bool wide)
+{
+    // the 256-lane kernel only pays once the lanes are filled
+    wide = wide && comp.cells.size() >= 8;
+    static thread_local SliceTables tables;
+    static thread_local vector<uint64_t> mines;
+    buildTables(comp, wide ? 4 : 1, tables);
+    mines.assign(comp.cells.size(), 0);
+    SliceSearch search(tables, mines);
+    if (wide) {
+        solution.total = count256(search);
+    } else {
+        solution.total = tables.base[0] ? descend64(search, 0, tables.base[0]) : 0;
+    }
+    solution.mine_counts.assign(mines.begin(), mines.end());
+}
@@ -0,0 +1,46 @@
+// ======================================================================
+// FILE:        BitSlice.hpp
+//
+// DESCRIPTION: This file contains the bit-sliced solver for small frontier
+//              components: the assignments of the component's squares are
+//              checked 64 or 256 at a time, one per bit lane, with bitwise
+//              arithmetic instead of a branch per square.
+//
+// NOTES:       - Assignment a puts a mine on square i if bit i of a is
+//                set. The low 6 bits (8 with AVX2) pick a lane of a word
+//                (of a 256-bit vector), so the low squares are fixed lane
+//                patterns, and each path of a depth-first walk over the
+//                rest, the high squares, is one word of assignments.
+//
+//              - Each number's count of low mines is added up once, in
+//                bit planes with bitwise adders, and turned into the lanes
+//                where the number is met for every count of its high
+//                mines. Once its last high square is set on a path, the
+//                path's valid lanes are ANDed with that mask, and a path
+//                with no valid lane left is cut. Every count is a
+//                popcount of the valid lanes.
+//
+//              - The AVX2 kernel is compiled for AVX2 alone and picked at
+//                run time when the CPU has it; the 64-lane kernel is the
+//                fallback. Both give the same counts as solveComponent's
+//                backtracking, which still handles larger components and
+//                those with mine_odds; --verify checks both against it
+//                (engine "bitslice", Verifier.hpp).
+// ======================================================================
+
+#ifndef MINE_SWEEPER_CPP_SHELL_BITSLICE_HPP
+#define MINE_SWEEPER_CPP_SHELL_BITSLICE_HPP
+
+#include "Frontier.hpp"
+
+// Largest component solved bit-sliced
+#define BITSLICE_MAX_CELLS 20
+
+// True if the CPU runs the 256-lane kernel
+bool bitSliceWide();
+
+// Counts the solutions of a component of at most BITSLICE_MAX_CELLS
+// squares without mine_odds, with the 256-lane kernel if 'wide'
+void bitSliceCount(const FrontierComponent& comp, ComponentSolution& solution, bool wide = bitSliceWide());
+
+#endif //MINE_SWEEPER_CPP_SHELL_BITSLICE_HPP
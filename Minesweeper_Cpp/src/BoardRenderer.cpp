@@ -0,0 +1,120 @@
+// ======================================================================
+// FILE:        BoardRenderer.cpp
+//
+// DESCRIPTION: This file contains the board renderer. See
+//              BoardRenderer.hpp.
+// ======================================================================
+
+#include "BoardRenderer.hpp"
+#include <cstdio>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+// Lines above the board (title, blank) and below it (rule, column
+// numbers) in a frame
+#define RENDER_HEAD_LINES 2
+#define RENDER_FOOT_LINES 2
+
+// Lines kept free under the board for the status and ManualAI's prompts
+#define RENDER_STATUS_LINES 10
+
+// Columns taken by the row number and bar left of the squares
+#define RENDER_LABEL_WIDTH 5
+
+void BoardRenderer::reset(int _rows, int _cols)
+{
+    rows = _rows;
+    cols = _cols;
+    width = max<int>(2, to_string(cols).size() + 1);
+    glyphs.assign(rows * cols, '.');
+    shown.clear();
+}
+
+void BoardRenderer::render(const string& status, ostream& out)
+{
+    frame.clear();
+    bool ansi = isatty(STDOUT_FILENO) && fitsTerminal();
+    if (ansi && shown.size() == glyphs.size()) {
+        renderChanges(status);
+    } else {
+        renderFull(status, ansi);
+    }
+    out.write(frame.data(), frame.size());
+    out.flush();
+}
+
+void BoardRenderer::renderFull(const string& status, bool ansi)
+{
+    char label[16];
+    if (ansi) {
+        frame += "\x1b[H\x1b[2J";   // home, clear screen
+    }
+    frame += "---------------- Game Board ------------------\n\n";
+    for (int r = rows - 1; r >= 0; --r) {
+        snprintf(label, sizeof(label), "%-4d|", r + 1);
+        frame += label;
+        for (int c = 0; c < cols; ++c) {
+            frame.append(width - 1, ' ');
+            frame += glyphs[r * cols + c];
+        }
+        frame += '\n';
+    }
+
+    frame.append(RENDER_LABEL_WIDTH, ' ');
+    for (int c = 0; c < cols; ++c) {
+        frame.append(width - 1, ' ');
+        frame += '-';
+    }
+    frame += '\n';
+    frame.append(RENDER_LABEL_WIDTH, ' ');
+    for (int c = 0; c < cols; ++c) {
+        snprintf(label, sizeof(label), "%*d", width, c + 1);
+        frame += label;
+    }
+    frame += '\n';
+    frame += status;
+
+    if (ansi) {
+        shown = glyphs;
+    } else {
+        shown.clear();
+    }
+}
+
+void BoardRenderer::renderChanges(const string& status)
+{
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            int i = r * cols + c;
+            if (glyphs[i] == shown[i]) {
+                continue;
+            }
+            moveTo(RENDER_HEAD_LINES + rows - r, RENDER_LABEL_WIDTH + (c + 1) * width);
+            frame += glyphs[i];
+            shown[i] = glyphs[i];
+        }
+    }
+    // the status, and whatever was printed after the last frame, is
+    // replaced in full
+    moveTo(RENDER_HEAD_LINES + rows + RENDER_FOOT_LINES + 1, 1);
+    frame += "\x1b[J";
+    frame += status;
+}
+
+// Cursor to a 1-based line and column
+void BoardRenderer::moveTo(int line, int column)
+{
+    char escape[32];
+    snprintf(escape, sizeof(escape), "\x1b[%d;%dH", line, column);
+    frame += escape;
+}
+
+bool BoardRenderer::fitsTerminal() const
+{
+    struct winsize size;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) != 0) {
+        return false;
+    }
+    return RENDER_HEAD_LINES + rows + RENDER_FOOT_LINES + RENDER_STATUS_LINES <= size.ws_row
+        && RENDER_LABEL_WIDTH + cols * width <= size.ws_col;
+}
@@ -0,0 +1,56 @@
+// ======================================================================
+// FILE:        BoardRenderer.hpp
+//
+// DESCRIPTION: This file contains the board renderer used by the debug
+//              and manual modes. A frame is built in one buffer and
+//              written with a single call.
+//
+// NOTES:       - On a terminal large enough to hold the board, only the
+//                first frame of a game is drawn in full. Later frames move
+//                the cursor (ANSI addressing) to the squares whose glyph
+//                changed and rewrite just those, then the status lines
+//                under the board.
+//
+//              - Otherwise (output redirected, or a board taller or wider
+//                than the terminal) every frame is written in full, with
+//                no escape sequences.
+//
+//              - Glyphs: '.' covered, '#' flagged, '*' mine, '0'-'8'.
+// ======================================================================
+
+#ifndef MINE_SWEEPER_CPP_SHELL_BOARDRENDERER_HPP
+#define MINE_SWEEPER_CPP_SHELL_BOARDRENDERER_HPP
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class BoardRenderer
+{
+public:
+    // Starts a new game: the next frame is drawn in full
+    void reset ( int rows, int cols );
+
+    // Sets the glyph of the square at column c, row r (row 0 at the bottom)
+    void set ( int c, int r, char glyph ) { glyphs[r * cols + c] = glyph; }
+
+    // Writes the board and, under it, the status text
+    void render ( const string& status, ostream& out );
+
+private:
+    void renderFull ( const string& status, bool ansi );
+    void renderChanges ( const string& status );
+    void moveTo ( int line, int column );
+    bool fitsTerminal () const;
+
+    int rows = 0;
+    int cols = 0;
+    int width = 2;              // columns per square
+    vector<char> glyphs;        // this frame, row-major
+    vector<char> shown;         // what the terminal shows, or empty
+    string frame;               // output buffer, reused between frames
+};
+
+#endif //MINE_SWEEPER_CPP_SHELL_BOARDRENDERER_HPP
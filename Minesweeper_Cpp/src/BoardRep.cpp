@@ -0,0 +1,333 @@
+// ======================================================================
+// FILE:        BoardRep.cpp
+//
+// DESCRIPTION: This file contains the agent's view of the board: the
+//              coordinate type, the coordinate containers used by the
+//              solver, and the BoardRep class itself.
+// ======================================================================
+
+#include "BoardRep.hpp"
+
+string Coord::toString() const {
+        return "(" + std::to_string(x+1) + ", " + std::to_string(y+1) + ")";
+}
+
+// Spreads the 32 bits of v out to the even bits of a 64-bit word
+static unsigned long long spread_bits(unsigned v) {
+    unsigned long long z = v;
+    z = (z | (z << 16)) & 0x0000FFFF0000FFFFULL;
+    z = (z | (z << 8))  & 0x00FF00FF00FF00FFULL;
+    z = (z | (z << 4))  & 0x0F0F0F0F0F0F0F0FULL;
+    z = (z | (z << 2))  & 0x3333333333333333ULL;
+    z = (z | (z << 1))  & 0x5555555555555555ULL;
+    return z;
+}
+
+// Z-order key of (x, y): x in the even bits, y in the odd bits. Covers the
+// full 32 bits of each axis, so large boards keep the same ordering.
+unsigned long long interleave_bits(int x, int y) {
+    return spread_bits(x) | (spread_bits(y) << 1);
+}
+
+bool Coord::operator<(const Coord& other) const {
+        return interleave_bits(x, y) < interleave_bits(other.x, other.y);
+}
+
+void CoordSet::setup(int _rowSize, int _colSize, bool _sparse)
+{
+    colSize = _colSize;
+    sparse = _sparse;
+    items.clear();
+    sparse_slot.clear();
+    if (sparse) {
+        slot.clear();
+        slot.shrink_to_fit();
+    } else {
+        items.reserve(_rowSize * _colSize);
+        slot.assign(_rowSize * _colSize, 0);
+    }
+}
+
+int CoordSet::sparseSlotOf(const Coord& c) const
+{
+    auto it = sparse_slot.find(key(c));
+    return it == sparse_slot.end() ? 0 : it->second;
+}
+
+void CoordSet::setSlot(const Coord& c, int s)
+{
+    if (!sparse)
+        slot[index(c)] = s;
+    else if (s)
+        sparse_slot[key(c)] = s;
+    else
+        sparse_slot.erase(key(c));
+}
+
+bool CoordSet::insert(const Coord& c)
+{
+    if (slotOf(c))
+        return false;
+    items.push_back(c);
+    setSlot(c, items.size());
+    return true;
+}
+
+size_t CoordSet::erase(const Coord& c)
+{
+    int s = slotOf(c);
+    if (!s)
+        return 0;
+    // move the last member into the hole
+    Coord last = items.back();
+    items[s - 1] = last;
+    setSlot(last, s);
+    items.pop_back();
+    setSlot(c, 0);
+    return 1;
+}
+
+void CoordSet::clear()
+{
+    if (sparse)
+        sparse_slot.clear();
+    else
+        for (const Coord& c : items)
+            slot[index(c)] = 0;
+    items.clear();
+}
+
+void CoordSet::fill()
+{
+    items.resize(slot.size());
+    for (int i = 0; i < (int) items.size(); ++i) {
+        items[i] = Coord(i % colSize, i / colSize);
+        slot[i] = i + 1;
+    }
+}
+
+Coord CoordSet::first() const
+{
+    return *min_element(items.begin(), items.end());
+}
+
+void CoordQueue::setup(int _rowSize, int _colSize, bool _sparse)
+{
+    colSize = _colSize;
+    sparse = _sparse;
+    items.clear();
+    sparse_queued.clear();
+    if (sparse) {
+        queued.clear();
+        queued.shrink_to_fit();
+    } else {
+        items.reserve(_rowSize * _colSize);
+        queued.assign(_rowSize * _colSize, 0);
+    }
+}
+
+void CoordQueue::push_back(const Coord& c)
+{
+    if (sparse) {
+        if (!sparse_queued.insert(key(c)).second)
+            return;
+    } else {
+        unsigned char& q = queued[index(c)];
+        if (q)
+            return;
+        q = 1;
+    }
+    items.push_back(c);
+}
+
+void CoordQueue::pop_back()
+{
+    if (sparse)
+        sparse_queued.erase(key(items.back()));
+    else
+        queued[index(items.back())] = 0;
+    items.pop_back();
+}
+
+void CoordQueue::clear()
+{
+    if (sparse)
+        sparse_queued.clear();
+    else
+        for (const Coord& c : items)
+            queued[index(c)] = 0;
+    items.clear();
+}
+
+// constructor for BoardRep
+BoardRep::BoardRep(int _rowDimension, int _colDimension, int _totalMines)
+    :rowSize(0), colSize(0), board(nullptr), squares(nullptr), large(false), tileCols(0)
+{   
+    reset(_rowDimension, _colDimension, _totalMines);
+}
+
+// destructor for BoardRep
+BoardRep::~BoardRep()
+{
+        delete[] board;
+        delete[] squares;
+        freeTiles();
+}
+
+// Starts a new game: every square covered and empty frontiers. The square
+// storage and coord sets are only reallocated if the dimensions changed.
+// Large boards drop their tiles instead, so memory follows the explored area.
+void BoardRep::reset(int _rowDimension, int _colDimension, int _totalMines)
+{
+    totalMines = _totalMines;
+    covered_sq_count = _rowDimension * _colDimension;
+    explore_cursor = 0;
+
+    if ((long long) _rowDimension * _colDimension > LARGE_BOARD_SQUARES) {
+        delete[] board;
+        delete[] squares;
+        board = nullptr;
+        squares = nullptr;
+        freeTiles();
+        large = true;
+        rowSize = _rowDimension;
+        colSize = _colDimension;
+        tileCols = (colSize + TILE_MASK) >> TILE_SHIFT;
+        tiles.assign((size_t) tileCols * ((rowSize + TILE_MASK) >> TILE_SHIFT), nullptr);
+        frontier_covered.setup(rowSize, colSize, true);
+        all_covered.setup(rowSize, colSize, true);
+        return;
+    }
+
+    if (large || _rowDimension != rowSize || _colDimension != colSize || !squares) {
+        freeTiles();
+        tiles.clear();
+        large = false;
+        delete[] board;
+        delete[] squares;
+        rowSize = _rowDimension;
+        colSize = _colDimension;
+        squares = new Square[rowSize * colSize];
+        board = new Square*[rowSize];
+        for (int i = 0; i < rowSize; ++i) {
+            board[i] = squares + i * colSize;
+        }
+        frontier_covered.setup(rowSize, colSize);
+        all_covered.setup(rowSize, colSize);
+    } else {
+        frontier_covered.clear();
+    }
+    std::fill(squares, squares + rowSize * colSize, COVERED);
+    all_covered.fill();
+}
+
+void BoardRep::freeTiles()
+{
+    for (Square*& tile : tiles) {
+        delete[] tile;
+        tile = nullptr;
+    }
+}
+
+// Returns the storage for a square of a large board. A tile that is still
+// entirely COVERED has no storage: nullptr is returned unless allocate is set,
+// in which case the tile is created with all of its squares COVERED.
+Square* BoardRep::tileSquare(int col, int row, bool allocate)
+{
+    Square*& tile = tiles[(size_t) (row >> TILE_SHIFT) * tileCols + (col >> TILE_SHIFT)];
+    if (!tile) {
+        if (!allocate)
+            return nullptr;
+        tile = new Square[TILE_SIZE * TILE_SIZE];
+        std::fill(tile, tile + TILE_SIZE * TILE_SIZE, COVERED);
+    }
+    return tile + (((row & TILE_MASK) << TILE_SHIFT) | (col & TILE_MASK));
+}
+
+// Finds a covered square that is not on the covered frontier. Squares only
+// ever leave that state, so the scan resumes where the last one stopped.
+bool BoardRep::findUnexplored(Coord& out)
+{
+    long long total = (long long) rowSize * colSize;
+    for (; explore_cursor < total; ++explore_cursor) {
+        Coord c(explore_cursor % colSize, explore_cursor / colSize);
+        if (getSquare(c.x, c.y) == COVERED && !frontier_covered.count(c)) {
+            out = c;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Returns True if the coordinate is uncovered
+bool BoardRep::isUncovered(Coord co) 
+{
+    return getSquare(co.x, co.y) >= 0;
+}
+
+// Returns True if both are covered or both are uncovered. Bounds checking is applied to b
+bool BoardRep::matchingStatus(Coord a, Coord b)
+{
+    return isUncovered(a) == isUncovered(b);
+}
+
+// Fills opposite_neighbors with all adjacent Coordinates of opposite status
+void BoardRep::listOppositeNeighbors(Coord coord, NeighborBuf& opposite_neighbors)
+{
+    Coord neighbor {0, 0};
+    for(int i = coord.x-1; i <= coord.x+1; ++i) {
+        for(int j = coord.y-1; j <= coord.y+1; ++j) {
+            neighbor = Coord{i, j};
+            if ((i != coord.x || j != coord.y) &&
+                withinBounds(i, j) &&
+                !matchingStatus(coord, neighbor))
+            {
+                opposite_neighbors.push_back(neighbor);
+            }
+        }
+    }
+}
+
+// Fills matching_neighbors with all adjacent Coordinates of matching status
+void BoardRep::listMatchingNeighbors(Coord coord, NeighborBuf& matching_neighbors)
+{
+    Coord neighbor {0, 0};
+    for(int i = coord.x-1; i <= coord.x+1; ++i) {
+        for(int j = coord.y-1; j <= coord.y+1; ++j) {
+            neighbor = Coord{i, j};
+            if ((i != coord.x || j != coord.y) &&
+                withinBounds(i, j) &&
+                matchingStatus(coord, neighbor))
+            {
+                matching_neighbors.push_back(neighbor);
+            }
+        }
+    }
+}
+
+// Marks the square at (row, col) as uncovered and stores its value. Returns false if square out of bounds
+bool BoardRep::updateSquare(int col, int row, Square value)
+{
+    if (!withinBounds(col, row)) {
+        return false;
+    } 
+    Square* square = large ? tileSquare(col, row, value != COVERED) : &board[row][col];
+    if (!square) {
+        return true; // an untouched tile is already all COVERED
+    }
+    // checks to make sure board had a covered square and then is getting uncovered
+    else if (*square == COVERED && value >= 0) {
+        covered_sq_count -= 1;
+        if (!large) {
+            all_covered.erase(Coord(col, row));
+        }
+    }
+    *square = value;
+    return true;
+}
+
+// returns true if isDone
+bool BoardRep::isDone()
+{
+    return covered_sq_count <= totalMines;
+}
@@ -0,0 +1,204 @@
+// ======================================================================
+// FILE:        BoardRep.hpp
+//
+// DESCRIPTION: This file contains the agent's view of the board: the
+//              coordinate type, the coordinate containers used by the
+//              solver, and the BoardRep class itself.
+// ======================================================================
+
+#ifndef MINE_SWEEPER_CPP_SHELL_BOARDREP_HPP
+#define MINE_SWEEPER_CPP_SHELL_BOARDREP_HPP
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+#define COVERED -1
+#define FLAGGED -2
+#define NUMBERED -3
+#define INVALID -4
+#define UNDEFINED -5
+typedef int Square;
+
+// Boards with more squares than this run in large-board mode: tiled square
+// storage, hashed coordinate sets and region-limited solving
+#define LARGE_BOARD_SQUARES (128 * 128)
+
+// Large boards store squares in TILE_SIZE x TILE_SIZE tiles that are only
+// allocated once one of their squares stops being COVERED
+#define TILE_SHIFT 5
+#define TILE_SIZE (1 << TILE_SHIFT)
+#define TILE_MASK (TILE_SIZE - 1)
+
+using namespace std;
+
+struct Coord {
+    int x;
+    int y;
+    Coord() : x(0), y(0) {}
+    Coord(int xCoord, int yCoord) : x(xCoord), y(yCoord) {}
+    string toString() const;
+    bool operator<(const Coord& other) const;
+    // Merge 5/24
+    bool operator==(const Coord& other) const {
+        return (x == other.x) && (y == other.y);
+    }
+};
+
+// Fixed-capacity list of up to N coordinates, kept inline so neighbor
+// scans on the hot path never touch the heap
+template <int N>
+struct CoordBuf {
+    Coord coords[N];
+    int count = 0;
+    void push_back(const Coord& c) { coords[count++] = c; }
+    int size() const { return count; }
+    const Coord* begin() const { return coords; }
+    const Coord* end() const { return coords + count; }
+};
+
+// The up to 8 neighbors of a square
+typedef CoordBuf<8> NeighborBuf;
+
+// The 8 rotations and reflections of the board, numbered 0-7 (0 is the
+// identity), applied to an offset
+inline Coord applySymmetry(int t, Coord c)
+{
+    if (t & 4) {
+        swap(c.x, c.y);
+    }
+    return Coord((t & 1) ? -c.x : c.x, (t & 2) ? -c.y : c.y);
+}
+
+// Set of board coordinates with O(1) insert/erase/lookup. Each cell has a
+// slot in a table sized to the board, and members are packed (unordered)
+// in a vector whose capacity is reserved up front, so neither operation
+// allocates once setup() has run. A sparse set keeps its slots in a hash
+// map instead, so its memory follows the member count, not the board size.
+class CoordSet
+{
+public:
+    void setup(int _rowSize, int _colSize, bool _sparse = false);
+    bool insert(const Coord& c);
+    size_t erase(const Coord& c);
+    size_t count(const Coord& c) const { return slotOf(c) != 0; }
+    int position(const Coord& c) const { return slotOf(c) - 1; } // index in insertion order while nothing is erased, or -1
+    const Coord& operator[](size_t i) const { return items[i]; }
+    size_t size() const { return items.size(); }
+    bool empty() const { return items.empty(); }
+    void clear();
+    void fill(); // make every square of the board a member
+    Coord first() const; // smallest member by Coord::operator<
+    vector<Coord>::const_iterator begin() const { return items.begin(); }
+    vector<Coord>::const_iterator end() const { return items.end(); }
+
+private:
+    int index(const Coord& c) const { return c.y * colSize + c.x; }
+    static long long key(const Coord& c) { return ((long long) c.y << 32) | (unsigned) c.x; }
+    int slotOf(const Coord& c) const { return sparse ? sparseSlotOf(c) : slot[index(c)]; }
+    int sparseSlotOf(const Coord& c) const;
+    void setSlot(const Coord& c, int s);
+    int colSize = 0;
+    bool sparse = false;
+    vector<Coord> items;
+    vector<int> slot; // position in items + 1, or 0 if absent
+    unordered_map<long long, int> sparse_slot;
+};
+
+// LIFO work queue of coordinates that holds each coordinate at most once.
+// An in-queue bitmap turns repeated pushes of a pending coordinate into
+// no-ops; popping clears the bit so the coordinate can be queued again.
+// A sparse queue tracks the queued coordinates in a hash set instead.
+class CoordQueue
+{
+public:
+    void setup(int _rowSize, int _colSize, bool _sparse = false);
+    void push_back(const Coord& c);
+    void pop_back();
+    const Coord& back() const { return items.back(); }
+    size_t size() const { return items.size(); }
+    bool empty() const { return items.empty(); }
+    void clear();
+    vector<Coord>::const_iterator begin() const { return items.begin(); }
+    vector<Coord>::const_iterator end() const { return items.end(); }
+
+private:
+    int index(const Coord& c) const { return c.y * colSize + c.x; }
+    static long long key(const Coord& c) { return ((long long) c.y << 32) | (unsigned) c.x; }
+    int colSize = 0;
+    bool sparse = false;
+    vector<Coord> items;
+    vector<unsigned char> queued;
+    unordered_set<long long> sparse_queued;
+};
+
+// BoardRepresentation Class
+class BoardRep 
+{
+public:
+    // variables of BoardRep
+    int rowSize;
+    int colSize;
+    int totalMines;
+    int covered_sq_count;
+    Square** board;  // row pointers into squares
+    Square* squares; // all squares, row after row
+
+    // Large-board mode: squares live in lazily allocated tiles instead of
+    // squares/board, and all_covered is not tracked
+    bool large;
+    int tileCols;
+    vector<Square*> tiles; // row-major tile grid, nullptr while all COVERED
+
+    // Merge 5/24
+    CoordSet frontier_covered;
+    CoordSet all_covered;
+
+    // functions in BoardRep
+    BoardRep(int _rowDimension, int _colDimension, int _totalMines);
+    ~BoardRep();
+    void reset(int _rowDimension, int _colDimension, int _totalMines);
+    bool updateSquare(int col, int row, Square value);
+    Square getSquare(int col, int row);
+    bool isDone();
+    bool withinBounds(int col, int row);
+    bool findUnexplored(Coord& out); // a covered square off the frontier, scanning forward from the last one found
+
+    // Merge 5/24
+    bool isUncovered(Coord co); // Returns True if the coordinate is uncovered
+    bool matchingStatus(Coord a, Coord b); // Returns True if both are covered or both are uncovered
+    void listOppositeNeighbors(Coord coord, NeighborBuf& neighbors); // Fills neighbors with the coords with Squares of opposite status
+    void listMatchingNeighbors(Coord coord, NeighborBuf& neighbors); // Fills neighbors with the matching neighbors
+
+private:
+    Square* tileSquare(int col, int row, bool allocate);
+    void freeTiles();
+    long long explore_cursor; // row-major index findUnexplored resumes from
+};
+
+// getSquare and withinBounds sit on the solver's innermost loops, so they
+// are defined here where every caller can inline them
+
+// Returns true only if provided row and col are within bounds.
+inline bool BoardRep::withinBounds(int col, int row)
+{
+    
+    return (row >= 0) && (row < rowSize) && (col >= 0) && (col < colSize);
+}
+
+// Returns the square at (row, col), returning INVALID if out of bounds
+inline Square BoardRep::getSquare(int col, int row) 
+{
+    if (!withinBounds(col, row)) {
+        return INVALID;
+    }
+    if (large) {
+        Square* square = tileSquare(col, row, false);
+        return square ? *square : COVERED;
+    }
+    return board[row][col];
+}
+
+#endif //MINE_SWEEPER_CPP_SHELL_BOARDREP_HPP
@@ -0,0 +1,295 @@
+// ======================================================================
+// FILE:        ComponentCache.cpp
+//
+// DESCRIPTION: This file contains the component cache: a persistent store
+//              of solved frontier components, keyed by a canonical form
+//              of their constraint structure.
+// ======================================================================
+
+#include "ComponentCache.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// File layout: magic, version, entry count, then the index of (hash,
+// record offset) pairs sorted by hash, then the records. A record is the
+// key length and value count (uint32 each), the key bytes and the values.
+static const char CACHE_MAGIC[4] = {'M', 'S', 'C', 'C'};
+static const uint32_t CACHE_VERSION = 1;
+static const size_t CACHE_HEADER_SIZE = 16;
+
+ComponentCache& ComponentCache::shared()
+{
+    static ComponentCache cache;
+    return cache;
+}
+
+ComponentCache::~ComponentCache()
+{
+    if (mapped)
+        munmap((void*) mapped, mapped_size);
+}
+
+namespace {
+
+void put16(string& out, int v)
+{
+    out.push_back((char) (v & 0xFF));
+    out.push_back((char) ((v >> 8) & 0xFF));
+}
+
+uint64_t fnv1a(const string& bytes)
+{
+    uint64_t h = 0xCBF29CE484222325ULL;
+    for (unsigned char c : bytes) {
+        h ^= c;
+        h *= 0x100000001B3ULL;
+    }
+    return h;
+}
+
+// True if the index is sorted by hash and every record it points to lies
+// within the file. Checked in an order that cannot overflow.
+bool validIndex(const char* bytes, size_t size, uint64_t count)
+{
+    const uint64_t* index = (const uint64_t*) (bytes + CACHE_HEADER_SIZE);
+    for (uint64_t i = 0; i < count; ++i) {
+        uint64_t offset = index[2 * i + 1];
+        if (i > 0 && index[2 * i] < index[2 * i - 2])
+            return false;
+        if (offset > size - 8)
+            return false;
+        uint32_t key_length, value_count;
+        memcpy(&key_length, bytes + offset, sizeof(key_length));
+        memcpy(&value_count, bytes + offset + 4, sizeof(value_count));
+        if ((uint64_t) key_length + (uint64_t) value_count * sizeof(double) > size - 8 - offset)
+            return false;
+    }
+    return true;
+}
+
+}
+
+// The key lists, for one symmetry of the component translated to start at
+// (0, 0), its squares and then its numbers with their remaining mines and
+// slack, both sorted by position. The smallest key over all 8 symmetries
+// is the canonical one.
+void ComponentCache::canonicalize(const FrontierComponent& comp, ComponentKey& key) const
+{
+    size_t n = comp.cells.size();
+    size_t m = comp.constraints.size();
+    vector<pair<pair<int, int>, int>> cells(n);          // ((y, x), square index)
+    vector<pair<pair<int, int>, pair<int, int>>> numbers(m); // ((y, x), (mines, slack))
+    string candidate;
+
+    key.bytes.clear();
+    for (int t = 0; t < 8; ++t) {
+        int min_x = 0, min_y = 0;
+        for (size_t i = 0; i < n; ++i) {
+            Coord c = applySymmetry(t, comp.cells[i]);
+            cells[i] = make_pair(make_pair(c.y, c.x), (int) i);
+            if (i == 0 || c.x < min_x) min_x = c.x;
+            if (i == 0 || c.y < min_y) min_y = c.y;
+        }
+        for (size_t k = 0; k < m; ++k) {
+            Coord c = applySymmetry(t, comp.numbers[k]);
+            numbers[k] = make_pair(make_pair(c.y, c.x), make_pair(comp.constraints[k].mines, comp.constraints[k].slack));
+            min_x = min(min_x, c.x);
+            min_y = min(min_y, c.y);
+        }
+        sort(cells.begin(), cells.end());
+        sort(numbers.begin(), numbers.end());
+
+        candidate.clear();
+        put16(candidate, n);
+        put16(candidate, m);
+        for (const auto& c : cells) {
+            put16(candidate, c.first.second - min_x);
+            put16(candidate, c.first.first - min_y);
+        }
+        for (const auto& number : numbers) {
+            put16(candidate, number.first.second - min_x);
+            put16(candidate, number.first.first - min_y);
+            candidate.push_back((char) number.second.first);
+            candidate.push_back((char) number.second.second);
+        }
+
+        if (t == 0 || candidate < key.bytes) {
+            key.bytes = candidate;
+            key.order.resize(n);
+            for (size_t i = 0; i < n; ++i)
+                key.order[i] = cells[i].second;
+        }
+    }
+    key.hash = fnv1a(key.bytes);
+}
+
+bool ComponentCache::lookup(const ComponentKey& key, ComponentSolution& solution)
+{
+    const vector<double>* values = nullptr;
+    vector<double> mapped_values;
+    string mapped_bytes;
+
+    auto it = fresh.find(key.bytes);
+    size_t index;
+    if (it != fresh.end()) {
+        ++it->second.hits;
+        values = &it->second.values;
+    } else if (findMapped(key, index)) {
+        ++mapped_hits[index];
+        readMapped(index, mapped_bytes, mapped_values);
+        values = &mapped_values;
+    }
+
+    if (!values || values->size() != key.order.size() + 1) {
+        ++misses;
+        return false;
+    }
+    ++hits;
+    solution.total = (*values)[0];
+    solution.mine_counts.assign(key.order.size(), 0);
+    for (size_t k = 0; k < key.order.size(); ++k)
+        solution.mine_counts[key.order[k]] = (*values)[k + 1];
+    return true;
+}
+
+void ComponentCache::store(const ComponentKey& key, const ComponentSolution& solution)
+{
+    if (size() >= cap || (!saving && fresh.size() >= COMPONENT_CACHE_RUN_CAP))
+        return;
+    Entry& entry = fresh[key.bytes];
+    entry.values.resize(key.order.size() + 1);
+    entry.values[0] = solution.total;
+    for (size_t k = 0; k < key.order.size(); ++k)
+        entry.values[k + 1] = solution.mine_counts[key.order[k]];
+}
+
+bool ComponentCache::open(const string& filename)
+{
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t) st.st_size < CACHE_HEADER_SIZE) {
+        close(fd);
+        return false;
+    }
+    void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return false;
+
+    const char* bytes = (const char*) data;
+    uint32_t version;
+    uint64_t count;
+    memcpy(&version, bytes + 4, sizeof(version));
+    memcpy(&count, bytes + 8, sizeof(count));
+    size_t size = st.st_size;
+    if (memcmp(bytes, CACHE_MAGIC, 4) != 0 || version != CACHE_VERSION ||
+        count > (size - CACHE_HEADER_SIZE) / 16 || !validIndex(bytes, size, count)) {
+        munmap(data, st.st_size);
+        return false;
+    }
+
+    mapped = bytes;
+    mapped_size = st.st_size;
+    mapped_count = count;
+    mapped_index = (const uint64_t*) (bytes + CACHE_HEADER_SIZE);
+    return true;
+}
+
+// Binary search of the index on the hash, then a full key compare over
+// the run of equal hashes
+bool ComponentCache::findMapped(const ComponentKey& key, size_t& index) const
+{
+    size_t lo = 0, hi = mapped_count;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (mapped_index[2 * mid] < key.hash)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    string bytes;
+    vector<double> values;
+    for (; lo < mapped_count && mapped_index[2 * lo] == key.hash; ++lo) {
+        readMapped(lo, bytes, values);
+        if (bytes == key.bytes) {
+            index = lo;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ComponentCache::readMapped(size_t index, string& bytes, vector<double>& values) const
+{
+    const char* record = mapped + mapped_index[2 * index + 1];
+    uint32_t key_length, value_count;
+    memcpy(&key_length, record, sizeof(key_length));
+    memcpy(&value_count, record + 4, sizeof(value_count));
+    bytes.assign(record + 8, key_length);
+    values.resize(value_count);
+    memcpy(values.data(), record + 8 + key_length, value_count * sizeof(double));
+}
+
+bool ComponentCache::save(const string& filename)
+{
+    // everything known, most hit first, cut to the cap
+    struct Saved {
+        string bytes;
+        vector<double> values;
+        long long hits;
+        uint64_t hash;
+    };
+    vector<Saved> all;
+    all.reserve(size());
+    for (size_t i = 0; i < mapped_count; ++i) {
+        Saved s;
+        readMapped(i, s.bytes, s.values);
+        auto h = mapped_hits.find(i);
+        s.hits = h == mapped_hits.end() ? 0 : h->second;
+        all.push_back(s);
+    }
+    for (const auto& f : fresh)
+        all.push_back(Saved{f.first, f.second.values, f.second.hits, 0});
+    stable_sort(all.begin(), all.end(), [](const Saved& a, const Saved& b) { return a.hits > b.hits; });
+    if (all.size() > cap)
+        all.resize(cap);
+    for (Saved& s : all)
+        s.hash = fnv1a(s.bytes);
+    sort(all.begin(), all.end(), [](const Saved& a, const Saved& b) {
+        return a.hash != b.hash ? a.hash < b.hash : a.bytes < b.bytes;
+    });
+
+    // write beside the target and rename over it, since the old file may
+    // still be mapped
+    string temp = filename + ".tmp";
+    ofstream file(temp, ios::binary | ios::trunc);
+    uint64_t count = all.size();
+    file.write(CACHE_MAGIC, 4);
+    file.write((const char*) &CACHE_VERSION, sizeof(CACHE_VERSION));
+    file.write((const char*) &count, sizeof(count));
+    uint64_t offset = CACHE_HEADER_SIZE + count * 16;
+    for (const Saved& s : all) {
+        file.write((const char*) &s.hash, sizeof(s.hash));
+        file.write((const char*) &offset, sizeof(offset));
+        offset += 8 + s.bytes.size() + s.values.size() * sizeof(double);
+    }
+    for (const Saved& s : all) {
+        uint32_t key_length = s.bytes.size();
+        uint32_t value_count = s.values.size();
+        file.write((const char*) &key_length, sizeof(key_length));
+        file.write((const char*) &value_count, sizeof(value_count));
+        file.write(s.bytes.data(), s.bytes.size());
+        file.write((const char*) s.values.data(), s.values.size() * sizeof(double));
+    }
+    file.close();
+    if (!file)
+        return false;
+    return rename(temp.c_str(), filename.c_str()) == 0;
+}
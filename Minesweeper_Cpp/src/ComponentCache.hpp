@@ -0,0 +1,100 @@
+// ======================================================================
+// FILE:        ComponentCache.hpp
+//
+// DESCRIPTION: This file contains the component cache: a persistent store
+//              of solved frontier components. A component is keyed by its
+//              constraint structure in a canonical geometric form, so the
+//              same shape anywhere on any board, in any of the 8
+//              orientations, shares one entry.
+//
+// NOTES:       - The store is a sorted file that is memory-mapped
+//                read-only at startup. Components solved during the run
+//                are kept in memory and merged into the file by save().
+//                open() checks the whole index first: a store whose
+//                records don't all lie within the file is refused, like one
+//                of another version, and the run starts empty.
+//
+//              - The full canonical key is stored and compared, so a hash
+//                collision can never return another component's answer.
+//
+//              - save() keeps at most 'cap' entries, preferring the ones
+//                that were hit most during the run.
+//
+//              - Solved components are kept in memory for the rest of the
+//                process either way, so a shape met again is looked up,
+//                not solved. Unless 'saving' is set (Main sets it for
+//                --component-db, whose store is written back), only the
+//                first COMPONENT_CACHE_RUN_CAP are kept: a long run
+//                without a store, a plugin or a library host, stays
+//                small.
+// ======================================================================
+
+#ifndef MINE_SWEEPER_CPP_SHELL_COMPONENTCACHE_HPP
+#define MINE_SWEEPER_CPP_SHELL_COMPONENTCACHE_HPP
+
+#include "Frontier.hpp"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+// Components smaller than this are cheaper to solve than to look up
+#define COMPONENT_CACHE_MIN_CELLS 6
+
+#define COMPONENT_CACHE_DEFAULT_CAP 1000000
+
+// Components kept in memory by a run that won't save them
+#define COMPONENT_CACHE_RUN_CAP 4096
+
+// Canonical form of a component: the key bytes, and for every canonical
+// position the index of the matching square in the component
+struct ComponentKey {
+    string bytes;
+    uint64_t hash;
+    vector<int> order;
+};
+
+class ComponentCache
+{
+public:
+    // The cache MyAI consults
+    static ComponentCache& shared();
+
+    ~ComponentCache();
+
+    bool open(const string& filename);  // maps an existing store read-only
+    bool save(const string& filename);  // writes mapped + new entries, up to cap
+
+    void canonicalize(const FrontierComponent& comp, ComponentKey& key) const;
+    bool lookup(const ComponentKey& key, ComponentSolution& solution);
+    void store(const ComponentKey& key, const ComponentSolution& solution);
+
+    size_t size() const { return mapped_count + fresh.size(); }
+
+    size_t cap = COMPONENT_CACHE_DEFAULT_CAP;
+    bool saving = false;                // save() will write this run's components
+    long long hits = 0;
+    long long misses = 0;
+
+private:
+    // A stored solution: total followed by the mine count of each
+    // canonical position
+    struct Entry {
+        vector<double> values;
+        long long hits = 0;
+    };
+
+    bool findMapped(const ComponentKey& key, size_t& index) const;
+    void readMapped(size_t index, string& bytes, vector<double>& values) const;
+
+    // memory-mapped store
+    const char* mapped = nullptr;
+    size_t mapped_size = 0;
+    size_t mapped_count = 0;
+    const uint64_t* mapped_index = nullptr; // (hash, record offset) pairs, sorted by hash
+    unordered_map<size_t, long long> mapped_hits;
+
+    // solved this run
+    unordered_map<string, Entry> fresh;
+};
+
+#endif //MINE_SWEEPER_CPP_SHELL_COMPONENTCACHE_HPP
@@ -0,0 +1,333 @@
+// ======================================================================
+// FILE:        Endgame.cpp
+//
+// DESCRIPTION: This file contains the endgame solver. See Endgame.hpp.
+// ======================================================================
+
+#include "Endgame.hpp"
+
+bool EndgameSolver::solve(BoardRep& board, int mines_left)
+{
+    safe.clear();
+    mines.clear();
+    win = -1;
+    left = mines_left;
+    if (board.large || board.all_covered.size() > ENDGAME_MAX_SQUARES || !collect(board)) {
+        return false;
+    }
+
+    size_t ni = interior.size();
+    binomial.assign(ni + 1, 1);
+    for (size_t j = 1; j <= ni; ++j) {
+        binomial[j] = binomial[j - 1] * (ni - j + 1) / j;
+    }
+
+    assignment.assign(cells.size(), 0);
+    counts.assign(cells.size(), 0);
+    total = 0;
+    interior_count = 0;
+    interior_safe = true;
+    interior_full = true;
+    nodes = 0;
+    leaves.clear();
+    search(0, 0);
+    if (nodes > ENDGAME_NODE_BUDGET || total == 0) {
+        return false;
+    }
+
+    // forced squares
+    for (int i : order) {
+        if (counts[i] == 0) {
+            safe.push_back(cells[i]);
+        } else if (counts[i] == total) {
+            mines.push_back(cells[i]);
+        }
+    }
+    if (ni && (interior_safe || interior_full)) {
+        for (int i : interior) {
+            (interior_safe ? safe : mines).push_back(cells[i]);
+        }
+    }
+    if (!safe.empty() || !mines.empty()) {
+        return true;
+    }
+
+    // no forced squares: the least likely mine, unless the expectimax
+    // finds a better one
+    guess_risk = 2;
+    for (int i : order) {
+        if (counts[i] / total < guess_risk) {
+            guess_risk = counts[i] / total;
+            guess = cells[i];
+        }
+    }
+    if (ni && interior_count / total < guess_risk) {
+        guess_risk = interior_count / total;
+        guess = cells[interior.front()];
+    }
+
+    // the budget may already be spent by an earlier solve of this move
+    if (evaluations > ENDGAME_EXPECTIMAX_BUDGET || !listPlacements()) {
+        return true;
+    }
+    memo.clear();
+    uint64_t all = placements.size() == 64 ? ~0ULL : (1ULL << placements.size()) - 1;
+    double best = -1;
+    int best_cell = -1;
+    for (size_t c = 0; c < cells.size(); ++c) {
+        double value = evaluate(all, c);
+        if (evaluations > ENDGAME_EXPECTIMAX_BUDGET) {
+            return true;    // keep the lowest risk guess
+        }
+        if (value > best) {
+            best = value;
+            best_cell = c;
+        }
+    }
+    if (best_cell >= 0) {
+        guess = cells[best_cell];
+        guess_risk = (double) __builtin_popcountll(all & mine_sets[best_cell]) / placements.size();
+        win = best;
+    }
+    return true;
+}
+
+// Lists the unknown squares, their unknown neighbors and the constraints
+// of the numbers around them. Frontier squares are ordered as the numbers
+// reach them, so each constraint closes soon after it opens.
+bool EndgameSolver::collect(BoardRep& board)
+{
+    cells.assign(board.all_covered.begin(), board.all_covered.end());
+    sort(cells.begin(), cells.end());
+    index_of.assign(board.rowSize * board.colSize, -1);
+    for (size_t i = 0; i < cells.size(); ++i) {
+        index_of[cells[i].y * board.colSize + cells[i].x] = i;
+    }
+
+    neighbors.assign(cells.size(), SquareMask());
+    constraints.clear();
+    cell_constraints.assign(cells.size(), vector<int>());
+    order.clear();
+    interior.clear();
+    vector<char> numbered(board.rowSize * board.colSize, 0);
+    vector<char> ordered(cells.size(), 0);
+
+    for (size_t i = 0; i < cells.size(); ++i) {
+        const Coord& c = cells[i];
+        for (int x = c.x - 1; x <= c.x + 1; ++x) {
+            for (int y = c.y - 1; y <= c.y + 1; ++y) {
+                Square square = board.getSquare(x, y);
+                if (square == COVERED && (x != c.x || y != c.y) && index_of[y * board.colSize + x] >= 0) {
+                    neighbors[i].set(index_of[y * board.colSize + x]);
+                }
+                if (square < 0 || numbered[y * board.colSize + x]) {
+                    continue;
+                }
+                numbered[y * board.colSize + x] = 1;
+
+                // a number next to this square becomes a constraint
+                Constraint constraint = {square, 0};
+                int k = constraints.size();
+                for (int u = x - 1; u <= x + 1; ++u) {
+                    for (int v = y - 1; v <= y + 1; ++v) {
+                        Square around = board.getSquare(u, v);
+                        if (around == FLAGGED) {
+                            --constraint.need;
+                        } else if (around == COVERED) {
+                            int j = index_of[v * board.colSize + u];
+                            if (j < 0) {
+                                return false;   // a covered square all_covered doesn't know
+                            }
+                            ++constraint.open;
+                            cell_constraints[j].push_back(k);
+                            if (!ordered[j]) {
+                                ordered[j] = 1;
+                                order.push_back(j);
+                            }
+                        }
+                    }
+                }
+                if (constraint.need < 0 || constraint.need > constraint.open) {
+                    return false;
+                }
+                constraints.push_back(constraint);
+            }
+        }
+    }
+    for (size_t i = 0; i < cells.size(); ++i) {
+        if (!ordered[i]) {
+            interior.push_back(i);
+        }
+    }
+    return true;
+}
+
+// Enumerates the frontier assignments that satisfy every number and leave
+// between 0 and interior.size() mines for the interior, weighting each by
+// the number of ways to place those mines
+void EndgameSolver::search(size_t depth, int placed)
+{
+    if (++nodes > ENDGAME_NODE_BUDGET) {
+        return;
+    }
+    int ni = interior.size();
+    if (placed > left || left - placed > (int) (order.size() - depth) + ni) {
+        return;
+    }
+
+    if (depth == order.size()) {
+        int j = left - placed;
+        double weight = binomial[j];
+        total += weight;
+        SquareMask mask;
+        for (int i : order) {
+            if (assignment[i]) {
+                counts[i] += weight;
+                mask.set(i);
+            }
+        }
+        if (ni) {
+            interior_count += weight * j / ni;
+        }
+        interior_safe = interior_safe && j == 0;
+        interior_full = interior_full && j == ni;
+        if (leaves.size() <= ENDGAME_MAX_PLACEMENTS) {
+            leaves.emplace_back(mask, placed);
+        }
+        return;
+    }
+
+    int cell = order[depth];
+    const vector<int>& around = cell_constraints[cell];
+    for (int value = 0; value <= 1; ++value) {
+        bool ok = true;
+        for (int k : around) {
+            Constraint& c = constraints[k];
+            --c.open;
+            c.need -= value;
+            ok = ok && c.need >= 0 && c.need <= c.open;
+        }
+        if (ok) {
+            assignment[cell] = value;
+            search(depth + 1, placed + value);
+        }
+        for (int k : around) {
+            ++constraints[k].open;
+            constraints[k].need += value;
+        }
+    }
+    assignment[cell] = 0;
+}
+
+// Expands the frontier assignments into every complete placement, filling
+// the interior with each combination of the mines left over (Gosper's
+// hack walks the combinations of an interior bit word in order)
+bool EndgameSolver::listPlacements()
+{
+    if (leaves.size() > ENDGAME_MAX_PLACEMENTS) {
+        return false;
+    }
+    int ni = interior.size();
+    double count = 0;
+    for (const auto& leaf : leaves) {
+        count += binomial[left - leaf.second];
+    }
+    if (count > ENDGAME_MAX_PLACEMENTS) {
+        return false;
+    }
+
+    placements.clear();
+    for (const auto& leaf : leaves) {
+        int j = left - leaf.second;
+        if (j == 0 || j == ni) {
+            SquareMask mask = leaf.first;
+            if (j) {
+                for (int i : interior) {
+                    mask.set(i);
+                }
+            }
+            placements.push_back(mask);
+            continue;
+        }
+        if (ni >= 64) {
+            return false;
+        }
+        for (uint64_t v = (1ULL << j) - 1; v < (1ULL << ni); ) {
+            SquareMask mask = leaf.first;
+            for (uint64_t bits = v; bits; bits &= bits - 1) {
+                mask.set(interior[__builtin_ctzll(bits)]);
+            }
+            placements.push_back(mask);
+            uint64_t t = v | (v - 1);
+            v = (t + 1) | (((~t & (t + 1)) - 1) >> (__builtin_ctzll(v) + 1));
+        }
+    }
+
+    mine_sets.assign(cells.size(), 0);
+    for (size_t p = 0; p < placements.size(); ++p) {
+        for (size_t c = 0; c < cells.size(); ++c) {
+            if (placements[p].test(c)) {
+                mine_sets[c] |= 1ULL << p;
+            }
+        }
+    }
+    return true;
+}
+
+// Chance of winning when the placement is one of 'set', from the best
+// square to uncover next
+double EndgameSolver::expectimax(uint64_t set)
+{
+    if (!(set & (set - 1))) {
+        return 1;   // one placement left: everything is known
+    }
+    auto it = memo.find(set);
+    if (it != memo.end()) {
+        return it->second;
+    }
+    if (evaluations > ENDGAME_EXPECTIMAX_BUDGET) {
+        return 0;
+    }
+
+    double size = __builtin_popcountll(set);
+    double best = 0;
+    for (size_t c = 0; c < cells.size() && best < 1; ++c) {
+        // the square can't do better than its chance of being safe
+        if (__builtin_popcountll(set & ~mine_sets[c]) / size <= best) {
+            continue;
+        }
+        best = max(best, evaluate(set, c));
+    }
+    memo[set] = best;
+    return best;
+}
+
+// Chance of winning by uncovering cell c next: the placements where it is
+// safe, split by the number it would show
+double EndgameSolver::evaluate(uint64_t set, int c)
+{
+    uint64_t safe_set = set & ~mine_sets[c];
+    if (!safe_set) {
+        return 0;
+    }
+    ++evaluations;
+
+    uint64_t groups[9] = {0};
+    for (uint64_t bits = safe_set; bits; bits &= bits - 1) {
+        int p = __builtin_ctzll(bits);
+        groups[placements[p].countIn(neighbors[c])] |= 1ULL << p;
+    }
+
+    double size = __builtin_popcountll(set);
+    double value = 0;
+    for (uint64_t group : groups) {
+        if (!group) {
+            continue;
+        }
+        if (group == set) {
+            return 0;   // always safe and always the same number: learns nothing
+        }
+        value += __builtin_popcountll(group) / size * expectimax(group);
+    }
+    return value;
+}
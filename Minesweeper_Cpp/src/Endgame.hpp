@@ -0,0 +1,117 @@
+// ======================================================================
+// FILE:        Endgame.hpp
+//
+// DESCRIPTION: This file contains the endgame solver. Once at most 128
+//              squares are still unknown, every one of them gets a bit in
+//              a pair of 64-bit words and the rest of the game is solved
+//              exactly, counting only placements with exactly the mines
+//              that are left.
+//
+// NOTES:       - The squares bordering numbers are enumerated; the others
+//                (the interior) are not, since any placement of the
+//                remaining mines among them is equally likely. A frontier
+//                assignment with k mines stands for C(interior, left - k)
+//                complete placements.
+//
+//              - When the complete placements are few enough to list (at
+//                most ENDGAME_MAX_PLACEMENTS), the guess is chosen by an
+//                expectimax over them: the value of a set of placements
+//                is the best, over all squares, of the chance the square
+//                is safe times the value of what its number would reveal.
+//                Sets of placements are 64-bit masks, so they memoize
+//                directly. Otherwise the guess is the square least likely
+//                to be a mine.
+//
+//              - ENDGAME_EXPECTIMAX_BUDGET covers a whole move, not one
+//                solve(): a move that flags mines solves again, and the
+//                later solves get what the earlier ones left. newMove()
+//                starts the next move's budget. The memo is kept for one
+//                solve only, since its keys index that solve's placements.
+// ======================================================================
+
+#ifndef MINE_SWEEPER_CPP_SHELL_ENDGAME_HPP
+#define MINE_SWEEPER_CPP_SHELL_ENDGAME_HPP
+
+#include "BoardRep.hpp"
+#include <cstdint>
+#include <unordered_map>
+
+#define ENDGAME_MAX_SQUARES 128
+
+// At most this many complete placements for the expectimax (one bit each)
+#define ENDGAME_MAX_PLACEMENTS 64
+
+// Search steps before the solver gives up: per solve() for the frontier
+// enumeration, per move for the expectimax
+#define ENDGAME_NODE_BUDGET 2000000
+#define ENDGAME_EXPECTIMAX_BUDGET 100000
+
+// A set of up to 128 squares, one bit per square
+struct SquareMask {
+    uint64_t w[2] = {0, 0};
+    void set(int i) { w[i >> 6] |= 1ULL << (i & 63); }
+    bool test(int i) const { return (w[i >> 6] >> (i & 63)) & 1; }
+    int countIn(const SquareMask& other) const {
+        return __builtin_popcountll(w[0] & other.w[0]) + __builtin_popcountll(w[1] & other.w[1]);
+    }
+};
+
+class EndgameSolver
+{
+public:
+    // Solves the board if at most ENDGAME_MAX_SQUARES squares are covered
+    // and not flagged. Returns false if there are more, or the search ran
+    // over budget, and the other engines should decide.
+    bool solve(BoardRep& board, int mines_left);
+
+    // Gives the next move a fresh expectimax budget
+    void newMove() { evaluations = 0; }
+
+    // The result: squares safe or mines in every placement, and when
+    // there are none, the best square to guess
+    vector<Coord> safe;
+    vector<Coord> mines;
+    Coord guess;
+    double guess_risk = 0;  // chance the guess is a mine
+    double win = -1;        // chance of winning from here with best play, or -1 if not searched
+
+private:
+    struct Constraint {
+        int need;   // mines still to place around the number
+        int open;   // squares around it not yet assigned
+    };
+
+    bool collect(BoardRep& board);
+    void search(size_t depth, int placed);
+    bool listPlacements();
+    double expectimax(uint64_t set);
+    double evaluate(uint64_t set, int c);
+
+    vector<Coord> cells;            // unknown squares; bit i is cells[i]
+    vector<int> index_of;           // board index -> cell index, or -1
+    vector<SquareMask> neighbors;   // unknown neighbors of each cell
+    vector<Constraint> constraints;
+    vector<vector<int>> cell_constraints;
+    vector<int> order;              // frontier cells in search order
+    vector<int> interior;           // cells next to no number
+    int left = 0;                   // mines not yet flagged
+
+    // frontier enumeration
+    vector<char> assignment;
+    vector<double> counts;          // weighted placements with each cell a mine
+    double total = 0;
+    double interior_count = 0;
+    bool interior_safe = true;      // no placement puts a mine in the interior
+    bool interior_full = true;      // every placement fills the interior
+    vector<double> binomial;        // C(interior, j)
+    long long nodes = 0;
+    vector<pair<SquareMask, int>> leaves;   // frontier assignments and their mine count
+
+    // expectimax
+    vector<SquareMask> placements;
+    vector<uint64_t> mine_sets;     // placements with each cell a mine
+    unordered_map<uint64_t, double> memo;
+    long long evaluations = 0;      // spent this move
+};
+
+#endif //MINE_SWEEPER_CPP_SHELL_ENDGAME_HPP
@@ -0,0 +1,230 @@
+// ======================================================================
+// FILE:        ExternalAgent.cpp
+//
+// DESCRIPTION: This file contains the external agent, which plays through
+//              another process over the binary pipe protocol described in
+//              ExternalAgent.hpp.
+// ======================================================================
+
+#include "ExternalAgent.hpp"
+#include <csignal>
+#include <cerrno>
+#include <iostream>
+#include <exception>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define FRAME_GAME 1
+#define FRAME_TURN 2
+
+// Upper bound on the actions in one ACTIONS frame, so a corrupt count
+// can't make World allocate without limit
+#define MAX_ACTIONS_PER_FRAME (1 << 20)
+
+ExternalAgent::ExternalAgent(const std::string& command, int _rowDimension, int _colDimension, int _totalMines, int _agentX, int _agentY)
+{
+    int request[2], reply[2];
+    if (pipe(request) != 0) {
+        throw std::exception();
+    }
+    if (pipe(reply) != 0) {
+        close(request[0]);
+        close(request[1]);
+        throw std::exception();
+    }
+
+    child = fork();
+    if (child < 0) {
+        close(request[0]);
+        close(request[1]);
+        close(reply[0]);
+        close(reply[1]);
+        throw std::exception();
+    }
+    if (child == 0) {
+        // its own process group, so killing it takes whatever it started too
+        setpgid(0, 0);
+        dup2(request[0], STDIN_FILENO);
+        dup2(reply[1], STDOUT_FILENO);
+        close(request[0]);
+        close(request[1]);
+        close(reply[0]);
+        close(reply[1]);
+        execl("/bin/sh", "sh", "-c", command.c_str(), (char*) nullptr);
+        _exit(127);
+    }
+    setpgid(child, child);
+    close(request[0]);
+    close(reply[1]);
+    toAgent = request[1];
+    fromAgent = reply[0];
+
+    // a process that exits early must show up as a failed write, not kill World
+    signal(SIGPIPE, SIG_IGN);
+
+    newGame(_rowDimension, _colDimension, _totalMines, _agentX, _agentY);
+}
+
+ExternalAgent::~ExternalAgent()
+{
+    // closing its stdin tells the process there are no more games; one
+    // that doesn't exit soon after is killed
+    close(toAgent);
+    close(fromAgent);
+    for (int waited = 0; waitpid(child, nullptr, WNOHANG) == 0; waited += 10) {
+        if (waited >= EXTERNAL_AGENT_EXIT_MS) {
+            kill(-child, SIGKILL);
+            waitpid(child, nullptr, 0);
+            break;
+        }
+        usleep(10000);
+    }
+}
+
+void ExternalAgent::newGame(int _rowDimension, int _colDimension, int _totalMines, int _agentX, int _agentY)
+{
+    rowDimension = _rowDimension;
+    colDimension = _colDimension;
+    totalMines = _totalMines;
+    agentX = _agentX;
+    agentY = _agentY;
+    if (broken) {
+        return;
+    }
+
+    // held back and sent with the first TURN frame
+    put(FRAME_GAME);
+    put(rowDimension);
+    put(colDimension);
+    put(totalMines);
+    put(agentX);
+    put(agentY);
+}
+
+Agent::Action ExternalAgent::getAction(int number)
+{
+    single.assign(1, number);
+    answer.clear();
+    getActions(single, answer);
+    return answer.front();
+}
+
+void ExternalAgent::getActions(const std::vector<int>& percepts, std::vector<Action>& actions)
+{
+    if (broken) {
+        actions.push_back({LEAVE, -1, -1});
+        return;
+    }
+    put(FRAME_TURN);
+    put((int) percepts.size());
+    out.insert(out.end(), percepts.begin(), percepts.end());
+
+    int count = 0;
+    deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(EXTERNAL_AGENT_TIMEOUT_MS);
+    if (!flush() || !readInts(&count, 1) || count < 1 || count > MAX_ACTIONS_PER_FRAME) {
+        fail();
+        actions.push_back({LEAVE, -1, -1});
+        return;
+    }
+    in.resize(3 * (size_t) count);
+    if (!readInts(in.data(), in.size())) {
+        fail();
+        actions.push_back({LEAVE, -1, -1});
+        return;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        Action action = {(Action_type) in[3 * i], in[3 * i + 1], in[3 * i + 2]};
+        if (!validAction(action)) {
+            action = {LEAVE, -1, -1};
+        }
+        actions.push_back(action);
+        if (action.action == LEAVE) {
+            break;
+        }
+    }
+}
+
+// The process is dropped for the rest of the run, and killed in case it
+// hung, so the destructor doesn't wait on it
+void ExternalAgent::fail()
+{
+    broken = true;
+    out.clear();
+    kill(-child, SIGKILL);
+}
+
+// Waits for fd to be ready for 'events' until the turn's deadline
+bool ExternalAgent::ready(int fd, short events)
+{
+    struct pollfd p = {fd, events, 0};
+    for (;;) {
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        if (left.count() <= 0) {
+            return false;
+        }
+        int got = poll(&p, 1, (int) left.count());
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        return got > 0;
+    }
+}
+
+bool ExternalAgent::flush()
+{
+    const char* data = (const char*) out.data();
+    size_t left = out.size() * sizeof(int);
+    while (left) {
+        if (!ready(toAgent, POLLOUT)) {
+            return false;
+        }
+        ssize_t written = write(toAgent, data, left);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        data += written;
+        left -= written;
+    }
+    out.clear();
+    return true;
+}
+
+bool ExternalAgent::readInts(int* values, size_t count)
+{
+    char* data = (char*) values;
+    size_t left = count * sizeof(int);
+    while (left) {
+        if (!ready(fromAgent, POLLIN)) {
+            return false;
+        }
+        ssize_t got = read(fromAgent, data, left);
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            return false;
+        }
+        data += got;
+        left -= got;
+    }
+    return true;
+}
+
+bool ExternalAgent::validAction(const Action& action) const
+{
+    switch (action.action) {
+        case LEAVE:
+            return true;
+        case UNCOVER:
+        case FLAG:
+        case UNFLAG:
+            return 0 <= action.x && action.x < colDimension && 0 <= action.y && action.y < rowDimension;
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,95 @@
+// ======================================================================
+// FILE:        ExternalAgent.hpp
+//
+// DESCRIPTION: This file contains the external agent: an Agent that
+//              forwards every turn to an agent running in another
+//              process, such as the Java or Python shells, over a pair of
+//              pipes. World scores it exactly like a native agent.
+//
+// NOTES:       - The command is run with /bin/sh -c. Its stdin and stdout
+//                carry the protocol; its stderr is left alone.
+//
+//              - One process plays every game of a run. A new game is
+//                announced with a GAME frame, and the process is told
+//                there are no more games when its stdin is closed.
+//
+//              - Protocol. Every field is a little-endian int32 and
+//                coordinates are 0-based (x = column, y = row, row 0 at
+//                the bottom), as in World.
+//
+//                  World -> agent
+//                    GAME   1, rows, cols, mines, startX, startY
+//                    TURN   2, n, percept * n
+//                  agent -> World
+//                    ACTIONS n, (action, x, y) * n
+//
+//                Every GAME frame is followed by a TURN frame holding the
+//                percept of the first square, and every TURN frame is
+//                answered by one ACTIONS frame with n >= 1. World applies
+//                the actions in order and the next TURN frame holds one
+//                percept per action applied (the number uncovered, or
+//                -1), so an agent may answer with several actions at once.
+//                GAME and TURN frames are written back to back without
+//                waiting, so a process never idles between games.
+//
+//              - An action World can't apply (an unknown action, a square
+//                off the board) ends the game as a LEAVE. So does a
+//                process that closes its pipes or takes longer than
+//                EXTERNAL_AGENT_TIMEOUT_MS to take a frame or answer a
+//                turn; it is killed, and every later turn of the run is a
+//                LEAVE. A process still running EXTERNAL_AGENT_EXIT_MS
+//                after its stdin is closed at the end of the run is
+//                killed too. The watchdog's deadlines (Watchdog.hpp), when
+//                set, are shorter and apply first.
+// ======================================================================
+
+#ifndef MINE_SWEEPER_CPP_SHELL_EXTERNALAGENT_HPP
+#define MINE_SWEEPER_CPP_SHELL_EXTERNALAGENT_HPP
+
+#include "Agent.hpp"
+#include <chrono>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+// Longest a process may take over one turn, longer than MyAI's budget for
+// a whole game, so only a process that stopped answering reaches it
+#define EXTERNAL_AGENT_TIMEOUT_MS 300000
+
+// Time a process gets to exit once it is told there are no more games
+#define EXTERNAL_AGENT_EXIT_MS 5000
+
+class ExternalAgent final : public Agent
+{
+public:
+    ExternalAgent ( const std::string& command, int _rowDimension, int _colDimension, int _totalMines, int _agentX, int _agentY );
+    ~ExternalAgent();
+
+    // Starts the next game on the same process
+    void newGame ( int _rowDimension, int _colDimension, int _totalMines, int _agentX, int _agentY );
+
+    Action getAction ( int number ) override;
+    bool supportsBatch () const override { return true; }
+    void getActions ( const std::vector<int>& percepts, std::vector<Action>& actions ) override;
+
+private:
+    void put ( int value ) { out.push_back( value ); }
+    bool flush ();                                  // write the pending frames
+    bool readInts ( int* values, size_t count );    // read exactly count ints
+    bool ready ( int fd, short events );
+    void fail ();
+    bool validAction ( const Action& action ) const;
+
+    pid_t   child   = -1;
+    int     toAgent = -1;       // write end of the agent's stdin
+    int     fromAgent = -1;     // read end of the agent's stdout
+    bool    broken  = false;    // the process failed; every answer is LEAVE
+    std::chrono::steady_clock::time_point deadline; // of the turn in progress
+
+    std::vector<int>    out;    // frames not yet written
+    std::vector<int>    in;     // the last ACTIONS frame read
+    std::vector<int>    single; // percept buffer for getAction
+    std::vector<Action> answer; // action buffer for getAction
+};
+
+#endif //MINE_SWEEPER_CPP_SHELL_EXTERNALAGENT_HPP
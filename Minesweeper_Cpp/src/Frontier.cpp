@@ -0,0 +1,229 @@
+// ======================================================================
+// FILE:        Frontier.cpp
+//
+// DESCRIPTION: This file contains the frontier region solver. The covered
+//              frontier is split into components, groups of covered
+//              squares linked through the numbered squares they share,
+//              and each component is turned into a small constraint
+//              system that can be solved on its own.
+// ======================================================================
+
+#include "Frontier.hpp"
+#include "BitSlice.hpp"
+
+void FrontierRegions::setup(int rowSize, int colSize, bool sparse)
+{
+    seen.setup(rowSize, colSize, sparse);
+    members.setup(rowSize, colSize, sparse);
+    numbered.setup(rowSize, colSize, sparse);
+}
+
+void FrontierRegions::split(BoardRep& board, size_t max_cells)
+{
+    components.clear();
+    seen.clear();
+    for (const Coord& seed : board.frontier_covered) {
+        if (seen.count(seed) || board.getSquare(seed.x, seed.y) != COVERED)
+            continue;
+        components.emplace_back();
+        grow(board, seed, max_cells, components.back());
+        addConstraints(board, components.back());
+    }
+}
+
+// Depth-first walk from seed over covered squares that share a numbered
+// neighbor, taking squares until the component is complete or full
+void FrontierRegions::grow(BoardRep& board, const Coord& seed, size_t max_cells, FrontierComponent& comp)
+{
+    members.clear();
+    stack.clear();
+    stack.push_back(seed);
+    while (!stack.empty()) {
+        Coord c = stack.back();
+        stack.pop_back();
+        if (members.count(c))
+            continue;
+        if (comp.cells.size() == max_cells) {
+            comp.truncated = true;
+            break;
+        }
+        members.insert(c);
+        seen.insert(c);
+        comp.cells.push_back(c);
+
+        for (int i = c.x-1; i <= c.x+1; ++i) {
+            for (int j = c.y-1; j <= c.y+1; ++j) {
+                if (board.getSquare(i, j) < 0)
+                    continue;
+                // covered squares around this number belong with c
+                for (int k = i-1; k <= i+1; ++k) {
+                    for (int l = j-1; l <= j+1; ++l) {
+                        if (board.getSquare(k, l) == COVERED && !members.count(Coord(k, l)))
+                            stack.push_back(Coord(k, l));
+                    }
+                }
+            }
+        }
+    }
+}
+
+// One constraint per numbered square touching the component
+void FrontierRegions::addConstraints(BoardRep& board, FrontierComponent& comp)
+{
+    numbered.clear();
+    for (const Coord& c : comp.cells) {
+        for (int i = c.x-1; i <= c.x+1; ++i) {
+            for (int j = c.y-1; j <= c.y+1; ++j) {
+                Square number = board.getSquare(i, j);
+                if (number < 0 || !numbered.insert(Coord(i, j)))
+                    continue;
+
+                Constraint constraint;
+                constraint.mines = number;
+                constraint.slack = 0;
+                for (int k = i-1; k <= i+1; ++k) {
+                    for (int l = j-1; l <= j+1; ++l) {
+                        Square s = board.getSquare(k, l);
+                        if (s == FLAGGED)
+                            --constraint.mines;
+                        else if (s == COVERED) {
+                            int index = members.position(Coord(k, l));
+                            if (index >= 0)
+                                constraint.cells.push_back(index);
+                            else
+                                ++constraint.slack;
+                        }
+                    }
+                }
+                comp.numbers.push_back(Coord(i, j));
+                comp.constraints.push_back(constraint);
+            }
+        }
+    }
+}
+
+namespace {
+
+// Backtracking state for solveComponent
+struct ComponentSearch {
+    const FrontierComponent& comp;
+    vector<vector<int>> cell_constraints; // constraints touching each square
+    vector<int> need;                     // mines still to place per constraint
+    vector<int> open;                     // unassigned squares + slack per constraint
+    vector<double>& mine_counts;
+
+    ComponentSearch(const FrontierComponent& c, vector<double>& counts)
+        : comp(c), cell_constraints(c.cells.size()), mine_counts(counts)
+    {
+        for (size_t k = 0; k < comp.constraints.size(); ++k) {
+            const Constraint& constraint = comp.constraints[k];
+            need.push_back(constraint.mines);
+            open.push_back(constraint.cells.size() + constraint.slack);
+            for (int cell : constraint.cells)
+                cell_constraints[cell].push_back(k);
+        }
+    }
+
+    // Assigns square i and reports whether every constraint it touches can
+    // still be met. The assignment is always applied; undo() reverts it.
+    bool assign(size_t i, int mine)
+    {
+        bool ok = true;
+        for (int k : cell_constraints[i]) {
+            need[k] -= mine;
+            --open[k];
+            if (need[k] < 0 || need[k] > open[k])
+                ok = false;
+        }
+        return ok;
+    }
+
+    void undo(size_t i, int mine)
+    {
+        for (int k : cell_constraints[i]) {
+            need[k] += mine;
+            ++open[k];
+        }
+    }
+
+    // Number of solutions for squares i.. given the squares before i,
+    // whose assignment weighs 'weight'. Adds each subtree with square j a
+    // mine to mine_counts[j].
+    double count(size_t i, double weight)
+    {
+        if (i == comp.cells.size())
+            return 1;
+        double total = 0;
+        for (int mine = 1; mine >= 0; --mine) {
+            if (assign(i, mine)) {
+                double odds = mine && !comp.mine_odds.empty() ? comp.mine_odds[i] : 1;
+                double sub = odds * count(i + 1, weight * odds);
+                if (mine)
+                    mine_counts[i] += weight * sub;
+                total += sub;
+            }
+            undo(i, mine);
+        }
+        return total;
+    }
+
+    // Widens [fewest, most] to the mines of every solution for squares
+    // i.., given 'mines' among the squares before i
+    void range(size_t i, int mines, int& fewest, int& most)
+    {
+        if (i == comp.cells.size()) {
+            fewest = min(fewest, mines);
+            most = max(most, mines);
+            return;
+        }
+        for (int mine = 1; mine >= 0; --mine) {
+            if (assign(i, mine))
+                range(i + 1, mines + mine, fewest, most);
+            undo(i, mine);
+        }
+    }
+};
+
+}
+
+bool componentFeasible(const FrontierComponent& comp)
+{
+    for (const Constraint& constraint : comp.constraints) {
+        if (constraint.mines < 0 || constraint.mines > (int) constraint.cells.size() + constraint.slack)
+            return false;
+    }
+    return true;
+}
+
+bool solveComponent(const FrontierComponent& comp, ComponentSolution& solution)
+{
+    if (comp.cells.size() <= BITSLICE_MAX_CELLS && comp.mine_odds.empty() && componentFeasible(comp)) {
+        bitSliceCount(comp, solution);
+        return solution.total > 0;
+    }
+    return backtrackComponent(comp, solution);
+}
+
+bool backtrackComponent(const FrontierComponent& comp, ComponentSolution& solution)
+{
+    solution.mine_counts.assign(comp.cells.size(), 0);
+    if (!componentFeasible(comp)) {
+        solution.total = 0;
+        return false;
+    }
+    ComponentSearch search(comp, solution.mine_counts);
+    solution.total = search.count(0, 1);
+    return solution.total > 0;
+}
+
+bool componentMineRange(const FrontierComponent& comp, int& fewest, int& most)
+{
+    fewest = comp.cells.size() + 1;
+    most = -1;
+    if (!componentFeasible(comp))
+        return false;
+    vector<double> unused;
+    ComponentSearch search(comp, unused);
+    search.range(0, 0, fewest, most);
+    return most >= 0;
+}
@@ -0,0 +1,83 @@
+// ======================================================================
+// FILE:        Frontier.hpp
+//
+// DESCRIPTION: This file contains the frontier region solver. The covered
+//              frontier is split into components, groups of covered
+//              squares linked through the numbered squares they share,
+//              and each component is turned into a small constraint
+//              system that can be solved on its own.
+//
+// NOTES:       - A component may be capped at a maximum size. Covered
+//                squares left out of it are counted as slack on the
+//                constraints they touch, which relaxes those constraints
+//                so every deduction made from the capped component is
+//                still sound.
+// ======================================================================
+
+#ifndef MINE_SWEEPER_CPP_SHELL_FRONTIER_HPP
+#define MINE_SWEEPER_CPP_SHELL_FRONTIER_HPP
+
+#include "BoardRep.hpp"
+
+// One numbered square: 'mines' of the component squares in 'cells', plus
+// up to 'slack' squares outside the component, are mines
+struct Constraint {
+    int mines;          // number on the square minus its flagged neighbors
+    int slack;          // covered neighbors that are not part of the component
+    vector<int> cells;  // indexes into FrontierComponent::cells
+};
+
+struct FrontierComponent {
+    vector<Coord> cells;            // covered squares, in search order
+    vector<Coord> numbers;          // numbered square of each constraint
+    vector<Constraint> constraints;
+    bool truncated = false;         // true if squares were cut off by the size cap
+    vector<double> mine_odds;       // weight of each square being a mine over safe; empty if all 1
+};
+
+// Per-square mine counts over all solutions of a component. With
+// mine_odds, a solution counts as the product of its mines' odds.
+struct ComponentSolution {
+    double total = 0;               // number of solutions
+    vector<double> mine_counts;     // solutions with each square a mine
+};
+
+class FrontierRegions
+{
+public:
+    void setup(int rowSize, int colSize, bool sparse);
+
+    // Splits board.frontier_covered into components of at most max_cells
+    // squares each. Squares cut from a full component seed later ones.
+    void split(BoardRep& board, size_t max_cells);
+
+    vector<FrontierComponent> components;
+
+private:
+    void grow(BoardRep& board, const Coord& seed, size_t max_cells, FrontierComponent& comp);
+    void addConstraints(BoardRep& board, FrontierComponent& comp);
+
+    CoordSet seen;      // squares already placed in a component
+    CoordSet members;   // squares of the component being built, by index
+    CoordSet numbered;  // numbered squares of the component being built
+    vector<Coord> stack;
+};
+
+// False if a number of the component needs more mines than it has
+// squares, or fewer than none
+bool componentFeasible(const FrontierComponent& comp);
+
+// Counts the solutions of a component by backtracking over its squares in
+// order, or bit-sliced (BitSlice.hpp) if it is small and has no
+// mine_odds. Returns false if the component has no solution at all.
+bool solveComponent(const FrontierComponent& comp, ComponentSolution& solution);
+
+// Counts them by backtracking alone: the engine the faster ones are
+// checked against (Verifier.hpp)
+bool backtrackComponent(const FrontierComponent& comp, ComponentSolution& solution);
+
+// The fewest and most mines among the component's squares over its
+// solutions. Returns false if it has none.
+bool componentMineRange(const FrontierComponent& comp, int& fewest, int& most);
+
+#endif //MINE_SWEEPER_CPP_SHELL_FRONTIER_HPP
@@ -0,0 +1,328 @@
+// ======================================================================
+// FILE:        GameTrace.cpp
+//
+// DESCRIPTION: This file contains the trace file reader and writer and
+//              the replay engine. The file format is described in
+//              GameTrace.hpp.
+// ======================================================================
+
+#include "GameTrace.hpp"
+#include "MyAI.hpp"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <iomanip>
+
+static const char TRACE_MAGIC[4] = {'M', 'S', 'T', 'R'};
+static const uint32_t TRACE_VERSION = 1;
+
+// Longest world name and largest board a record may hold
+#define TRACE_MAX_NAME (1 << 16)
+#define TRACE_MAX_SQUARES (1LL << 28)
+
+// Fewest bytes a move and a reveal take: one per varint
+#define TRACE_MIN_MOVE_BYTES 6
+#define TRACE_MIN_REVEAL_BYTES 3
+
+// Slowest moves listed at the end of a replay
+#define REPLAY_SLOWEST_MOVES 10
+
+namespace {
+
+void putVarint(std::string& out, uint64_t value)
+{
+    while (value >= 0x80) {
+        out.push_back((char) (value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((char) value);
+}
+
+}
+
+void GameTrace::clear()
+{
+    world.clear();
+    seed = 0;
+    score = 0;
+    moves.clear();
+    reveals.clear();
+}
+
+bool TraceWriter::open(const std::string& filename)
+{
+    file.open(filename, std::ios::binary | std::ios::trunc);
+    file.write(TRACE_MAGIC, 4);
+    file.write((const char*) &TRACE_VERSION, sizeof(TRACE_VERSION));
+    return (bool) file;
+}
+
+bool TraceWriter::write(const GameTrace& game)
+{
+    buffer.clear();
+    putVarint(buffer, game.world.size());
+    buffer += game.world;
+    putVarint(buffer, game.seed);
+    putVarint(buffer, game.rows);
+    putVarint(buffer, game.cols);
+    putVarint(buffer, game.mines);
+    putVarint(buffer, game.startX);
+    putVarint(buffer, game.startY);
+    putVarint(buffer, game.score);
+    putVarint(buffer, game.moves.size());
+
+    const Agent::Reveal* reveal = game.reveals.data();
+    for (const TraceMove& move : game.moves) {
+        putVarint(buffer, move.percept + 1);
+        putVarint(buffer, move.reveals);
+        for (int i = 0; i < move.reveals; ++i, ++reveal) {
+            putVarint(buffer, reveal->x);
+            putVarint(buffer, reveal->y);
+            putVarint(buffer, reveal->number);
+        }
+        putVarint(buffer, move.action.action);
+        putVarint(buffer, move.action.x + 1);
+        putVarint(buffer, move.action.y + 1);
+        putVarint(buffer, move.nanos);
+    }
+
+    file.write(buffer.data(), buffer.size());
+    file.flush();
+    return (bool) file;
+}
+
+bool TraceReader::open(const std::string& filename)
+{
+    file.open(filename, std::ios::binary);
+    char magic[4];
+    uint32_t version;
+    file.read(magic, 4);
+    file.read((char*) &version, sizeof(version));
+    if (!file || memcmp(magic, TRACE_MAGIC, 4) != 0 || version != TRACE_VERSION) {
+        return false;
+    }
+    std::streampos start = file.tellg();
+    file.seekg(0, std::ios::end);
+    end = file.tellg();
+    file.seekg(start);
+    return (bool) file;
+}
+
+uint64_t TraceReader::remaining()
+{
+    std::streampos at = file.tellg();
+    return at < 0 || at > end ? 0 : (uint64_t) (end - at);
+}
+
+bool TraceReader::readVarint(uint64_t& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int byte = file.get();
+        if (byte == EOF) {
+            return false;
+        }
+        value |= (uint64_t) (byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Every length is checked against the bytes left before it is used, and
+// every value against the board, so a corrupt record is refused rather
+// than allocated or replayed
+bool TraceReader::next(GameTrace& game)
+{
+    uint64_t v[8];
+    game.clear();
+    if (!readVarint(v[0]) || v[0] > TRACE_MAX_NAME || v[0] > remaining()) {
+        return false;
+    }
+    game.world.resize(v[0]);
+    if (!file.read(&game.world[0], v[0])) {
+        return false;
+    }
+    for (int i = 0; i < 8; ++i) {
+        if (!readVarint(v[i])) {
+            return false;
+        }
+    }
+    uint64_t rows = v[1], cols = v[2], mines = v[3], startX = v[4], startY = v[5], moveCount = v[7];
+    if (rows < 1 || cols < 1 || rows > TRACE_MAX_SQUARES || cols > TRACE_MAX_SQUARES
+        || rows * cols > TRACE_MAX_SQUARES || mines >= rows * cols || startX >= cols || startY >= rows
+        || v[0] > UINT32_MAX || v[6] > INT_MAX || moveCount > remaining() / TRACE_MIN_MOVE_BYTES) {
+        return false;
+    }
+    game.seed = v[0];
+    game.rows = rows;
+    game.cols = cols;
+    game.mines = mines;
+    game.startX = startX;
+    game.startY = startY;
+    game.score = v[6];
+    game.moves.reserve(moveCount);
+
+    for (uint64_t m = 0; m < moveCount; ++m) {
+        TraceMove move;
+        uint64_t percept, count;
+        if (!readVarint(percept) || !readVarint(count) || percept > 9 || count > rows * cols
+            || count > remaining() / TRACE_MIN_REVEAL_BYTES) {
+            return false;
+        }
+        move.percept = (int) percept - 1;
+        move.reveals = count;
+        for (uint64_t i = 0; i < count; ++i) {
+            uint64_t x, y, number;
+            if (!readVarint(x) || !readVarint(y) || !readVarint(number) || x >= cols || y >= rows || number > 8) {
+                return false;
+            }
+            game.reveals.push_back({(int) x, (int) y, (int) number});
+        }
+        uint64_t action, x, y, nanos;
+        if (!readVarint(action) || !readVarint(x) || !readVarint(y) || !readVarint(nanos)
+            || action > Agent::UNFLAG || x > cols || y > rows) {
+            return false;
+        }
+        move.action = {(Agent::Action_type) action, (int) x - 1, (int) y - 1};
+        move.nanos = nanos;
+        game.moves.push_back(move);
+    }
+    return true;
+}
+
+// ===============================================================
+// =                        Replay
+// ===============================================================
+
+namespace {
+
+struct SlowMove {
+    uint64_t    nanos;      // replayed
+    uint64_t    recorded;
+    int         game;
+    int         move;
+};
+
+// The world's file name without its directory, or its seed
+string displayName(const GameTrace& game)
+{
+    if (game.world.empty()) {
+        return "seed " + to_string(game.seed);
+    }
+    size_t slash = game.world.rfind('/');
+    return slash == string::npos ? game.world : game.world.substr(slash + 1);
+}
+
+bool sameAction(const Agent::Action& a, const Agent::Action& b)
+{
+    if (a.action != b.action) {
+        return false;
+    }
+    return a.action == Agent::LEAVE || (a.x == b.x && a.y == b.y);
+}
+
+}
+
+bool replayTraces(const std::string& filename, int repeat, std::ostream& out)
+{
+    TraceReader reader;
+    if (!reader.open(filename)) {
+        return false;
+    }
+
+    GameTrace game;
+    MyAI* agent = nullptr;
+    vector<uint64_t> best;
+    vector<Agent::Reveal> batch;
+    vector<SlowMove> slowest;
+    vector<string> worlds;
+    uint64_t totalRecorded = 0, totalReplayed = 0;
+    int games = 0, diverged = 0;
+
+    out << left << setw(32) << "world" << right << setw(8) << "moves" << setw(14) << "recorded ms"
+        << setw(14) << "replay ms" << setw(8) << "slowest" << setw(14) << "slowest us" << endl;
+
+    while (reader.next(game)) {
+        best.assign(game.moves.size(), UINT64_MAX);
+        int played = (int) game.moves.size();
+        for (int round = 0; round < max(repeat, 1); ++round) {
+            if (agent) {
+                agent->reset(game.rows, game.cols, game.mines, game.startX, game.startY);
+            } else {
+                agent = new MyAI(game.rows, game.cols, game.mines, game.startX, game.startY);
+            }
+            ProfileScope profile(PROFILE_GAME);
+
+            const Agent::Reveal* reveal = game.reveals.data();
+            for (int m = 0; m < played; ++m) {
+                const TraceMove& move = game.moves[m];
+                batch.assign(reveal, reveal + move.reveals);
+                reveal += move.reveals;
+
+                auto start = std::chrono::steady_clock::now();
+                if (!batch.empty()) {
+                    agent->revealed(batch);
+                }
+                Agent::Action action = agent->getAction(move.percept);
+                uint64_t nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+                best[m] = min(best[m], nanos);
+
+                if (!sameAction(action, move.action)) {
+                    if (round == 0) {
+                        out << "[WARNING] " << displayName(game) << " diverges from the trace at move " << m + 1 << endl;
+                        ++diverged;
+                    }
+                    played = m + 1;
+                    break;
+                }
+            }
+        }
+
+        uint64_t recorded = 0, replayed = 0;
+        int slowestMove = 0;
+        for (int m = 0; m < played; ++m) {
+            recorded += game.moves[m].nanos;
+            replayed += best[m];
+            if (best[m] > best[slowestMove]) {
+                slowestMove = m;
+            }
+            slowest.push_back({best[m], game.moves[m].nanos, games, m});
+        }
+        // keep only the candidates for the final list
+        if (slowest.size() > 4 * REPLAY_SLOWEST_MOVES) {
+            nth_element(slowest.begin(), slowest.begin() + REPLAY_SLOWEST_MOVES, slowest.end(),
+                        [](const SlowMove& a, const SlowMove& b) { return a.nanos > b.nanos; });
+            slowest.resize(REPLAY_SLOWEST_MOVES);
+        }
+        totalRecorded += recorded;
+        totalReplayed += replayed;
+
+        string name = displayName(game);
+        worlds.push_back(name);
+        out << left << setw(32) << name << right << setw(8) << played
+            << fixed << setprecision(3) << setw(14) << recorded / 1e6 << setw(14) << replayed / 1e6
+            << setw(8) << slowestMove + 1 << setprecision(1) << setw(14) << (played ? best[slowestMove] / 1e3 : 0) << endl;
+        ++games;
+    }
+    delete agent;
+
+    sort(slowest.begin(), slowest.end(), [](const SlowMove& a, const SlowMove& b) { return a.nanos > b.nanos; });
+    if (slowest.size() > REPLAY_SLOWEST_MOVES) {
+        slowest.resize(REPLAY_SLOWEST_MOVES);
+    }
+
+    out << endl << "Replayed " << games << " games";
+    if (diverged) {
+        out << " (" << diverged << " diverged)";
+    }
+    out << fixed << setprecision(3) << ": recorded " << totalRecorded / 1e6 << " ms, replay " << totalReplayed / 1e6 << " ms" << endl;
+    out << endl << "Slowest moves:" << endl;
+    for (const SlowMove& s : slowest) {
+        out << "  " << left << setw(32) << worlds[s.game] << right << " move " << setw(6) << s.move + 1
+            << setprecision(1) << "  replay " << setw(12) << s.nanos / 1e3 << " us  recorded " << setw(12) << s.recorded / 1e3 << " us" << endl;
+    }
+    return true;
+}
@@ -0,0 +1,97 @@
+// ======================================================================
+// FILE:        GameTrace.hpp
+//
+// DESCRIPTION: This file contains game traces: a compact record of every
+//              turn of a game (the percepts the agent was given, the
+//              action it answered with, and how long it took), the
+//              reader and writer for trace files, and the replay engine
+//              that feeds a recorded game back into MyAI.
+//
+// NOTES:       - A trace file is the magic "MSTR", a uint32 version, then
+//                one record per game until the end of the file. Every
+//                number in a record is an unsigned LEB128 varint, and
+//                values that may be -1 are stored plus one:
+//
+//                  world name length, world name bytes, seed,
+//                  rows, cols, mines, startX, startY, score, move count,
+//                  then per move:
+//                    percept + 1, reveal count, (x, y, number) * count,
+//                    action, x + 1, y + 1, agent time in nanoseconds
+//
+//                The reveals are the squares a cascade (see --cascade)
+//                handed the agent before that turn. A game is written
+//                whole once it ends, so an interrupted run loses at most
+//                the game in progress.
+//
+//              - The world name is the world file, or empty for a random
+//                world, which the seed regenerates.
+//
+//              - MyAI has no randomness, so a replay makes the recorded
+//                moves again unless its time budget decides differently.
+//                A replay that answers differently from the trace stops
+//                that game and reports the move where it diverged.
+// ======================================================================
+
+#ifndef MINE_SWEEPER_CPP_SHELL_GAMETRACE_HPP
+#define MINE_SWEEPER_CPP_SHELL_GAMETRACE_HPP
+
+#include "Agent.hpp"
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// One agent turn
+struct TraceMove {
+    int             percept;    // number given to getAction
+    int             reveals;    // squares given to revealed() first, from GameTrace::reveals
+    Agent::Action   action;     // the agent's answer
+    uint64_t        nanos;      // time spent in the agent
+};
+
+struct GameTrace {
+    std::string world;
+    uint32_t    seed = 0;
+    int         rows = 0;
+    int         cols = 0;
+    int         mines = 0;
+    int         startX = 0;
+    int         startY = 0;
+    int         score = 0;
+    std::vector<TraceMove>      moves;
+    std::vector<Agent::Reveal>  reveals;    // every move's reveals, in order
+
+    void clear();
+};
+
+class TraceWriter
+{
+public:
+    bool open ( const std::string& filename );
+    bool write ( const GameTrace& game );   // appends one game record
+
+private:
+    std::ofstream   file;
+    std::string     buffer; // the record being encoded
+};
+
+class TraceReader
+{
+public:
+    bool open ( const std::string& filename );
+    bool next ( GameTrace& game );  // false at the end of the file or on a corrupt record
+
+private:
+    bool readVarint ( uint64_t& value );
+    uint64_t remaining ();  // bytes left in the file
+    std::ifstream   file;
+    std::streampos  end;
+};
+
+// Replays every game of a trace file through MyAI, 'repeat' times each
+// keeping the fastest time of every move, and prints per-game timings and
+// the slowest moves to out. Returns false if the file can't be read.
+bool replayTraces ( const std::string& filename, int repeat, std::ostream& out );
+
+#endif //MINE_SWEEPER_CPP_SHELL_GAMETRACE_HPP
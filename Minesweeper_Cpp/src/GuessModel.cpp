@@ -0,0 +1,144 @@
+// ======================================================================
+// FILE:        GuessModel.cpp
+//
+// DESCRIPTION: This file contains the guess model. See GuessModel.hpp.
+// ======================================================================
+
+#include "GuessModel.hpp"
+#include "GuessWeights.hpp"
+#include <cmath>
+#include <cstdlib>
+
+namespace {
+
+// The share of a numbered square's covered neighbors that are mines, from
+// the mines it still needs and its covered neighbors
+double numberDensity(BoardRep& board, int x, int y, int& need, int& covered)
+{
+    need = board.getSquare(x, y);
+    covered = 0;
+    for (int i = x-1; i <= x+1; ++i) {
+        for (int j = y-1; j <= y+1; ++j) {
+            if (!board.withinBounds(i, j)) {
+                continue;
+            }
+            Square s = board.getSquare(i, j);
+            need -= s == FLAGGED;
+            covered += s == COVERED;
+        }
+    }
+    return covered ? min(max((double) need / covered, 0.0), 1.0) : 0;
+}
+
+}
+
+void guessFeatures(BoardRep& board, const Coord& c, double density, float* out, size_t stride)
+{
+    int numbered = 0, covered = 0, flagged = 0, outside = 0;
+    int window_covered = 0, window_numbered = 0, fewest = 8, needed = 0;
+    double highest = 0, lowest = 1, sum = 0, all_safe = 1, ring = 0;
+    for (int dx = -2; dx <= 2; ++dx) {
+        for (int dy = -2; dy <= 2; ++dy) {
+            if (!dx && !dy) {
+                continue;
+            }
+            int x = c.x + dx, y = c.y + dy;
+            bool near = abs(dx) <= 1 && abs(dy) <= 1;
+            if (!board.withinBounds(x, y)) {
+                outside += near;
+                continue;
+            }
+            Square s = board.getSquare(x, y);
+            if (s == COVERED) {
+                ++window_covered;
+                covered += near;
+            } else if (s == FLAGGED) {
+                flagged += near;
+            } else if (s >= 0) {
+                ++window_numbered;
+                int need, around;
+                double d = numberDensity(board, x, y, need, around);
+                if (near) {
+                    fewest = min(fewest, around);
+                    needed += need;
+                    ++numbered;
+                    highest = max(highest, d);
+                    lowest = min(lowest, d);
+                    sum += d;
+                    all_safe *= 1 - d;
+                } else {
+                    ring = max(ring, d);
+                }
+            }
+        }
+    }
+
+    float f[GUESS_FEATURES] = {
+        1,
+        (float) density,
+        numbered / 8.0f,
+        covered / 8.0f,
+        flagged / 8.0f,
+        outside / 8.0f,
+        (float) highest,
+        numbered ? (float) lowest : 0,
+        numbered ? (float) (sum / numbered) : 0,
+        numbered ? (float) (1 - all_safe) : 0,
+        fewest / 8.0f,
+        (float) ring,
+        window_covered / 24.0f,
+        window_numbered / 24.0f,
+        (float) (highest * highest),
+        needed / 8.0f
+    };
+    for (int i = 0; i < GUESS_FEATURES; ++i) {
+        out[i * stride] = f[i];
+    }
+}
+
+void guessMineChances(const float* features, size_t count, float* chances)
+{
+    for (size_t k = 0; k < count; ++k) {
+        chances[k] = 0;
+    }
+    // feature by feature, so each pass is a vectorized multiply-add
+    for (int i = 0; i < GUESS_FEATURES; ++i) {
+        const float weight = GUESS_WEIGHTS[i];
+        const float* column = features + i * count;
+        for (size_t k = 0; k < count; ++k) {
+            chances[k] += weight * column[k];
+        }
+    }
+    for (size_t k = 0; k < count; ++k) {
+        chances[k] = 1 / (1 + exp(-chances[k]));
+    }
+}
+
+bool guessSquare(BoardRep& board, double density, Coord& guess)
+{
+    static thread_local vector<float> features, chances;
+    size_t count = board.frontier_covered.size();
+    features.resize(count * GUESS_FEATURES);
+    chances.resize(count);
+    for (size_t k = 0; k < count; ++k) {
+        guessFeatures(board, board.frontier_covered[k], density, &features[k], count);
+    }
+    guessMineChances(features.data(), count, chances.data());
+
+    float lowest = 2;
+    for (size_t k = 0; k < count; ++k) {
+        if (chances[k] < lowest) {
+            lowest = chances[k];
+            guess = board.frontier_covered[k];
+        }
+    }
+    if (density < lowest && !board.large) {
+        for (const Coord& c : board.all_covered) {
+            if (!board.frontier_covered.count(c)) {
+                guess = c;
+                return true;
+            }
+        }
+    }
+    return lowest <= 1;
+}
@@ -0,0 +1,43 @@
+// ======================================================================
+// FILE:        GuessModel.hpp
+//
+// DESCRIPTION: This file contains the guess model: a logistic model of
+//              the chance a frontier square is a mine, from features of
+//              the squares around it. MyAI falls back on it when the time
+//              budget is nearly spent and the frontier is too big to
+//              solve, instead of guessing blindly.
+//
+// NOTES:       - The weights are compiled in from GuessWeights.hpp, which
+//                --train-guess writes from recorded games (GuessTraining.hpp).
+//                Changing a feature below means training the weights again.
+//
+//              - Candidates are scored together: their features are laid
+//                out feature by feature, so the weighted sum runs across
+//                candidates and the compiler vectorizes it; a whole
+//                frontier is scored in microseconds.
+//
+//              - A square off the frontier is taken at the mine density
+//                and wins if it is safer than every frontier square.
+// ======================================================================
+
+#ifndef MINE_SWEEPER_CPP_SHELL_GUESSMODEL_HPP
+#define MINE_SWEEPER_CPP_SHELL_GUESSMODEL_HPP
+
+#include "BoardRep.hpp"
+
+#define GUESS_FEATURES 16
+
+// Writes the features of covered square c to out[0], out[stride], ...
+// out[(GUESS_FEATURES - 1) * stride]. 'density' is the chance a square
+// off the frontier is a mine.
+void guessFeatures(BoardRep& board, const Coord& c, double density, float* out, size_t stride = 1);
+
+// The model's chance that each of 'count' squares is a mine, from their
+// features laid out as guessFeatures writes them with stride 'count'
+void guessMineChances(const float* features, size_t count, float* chances);
+
+// The covered square the model finds least likely to be a mine. Returns
+// false if no square is covered.
+bool guessSquare(BoardRep& board, double density, Coord& guess);
+
+#endif //MINE_SWEEPER_CPP_SHELL_GUESSMODEL_HPP
@@ -0,0 +1,269 @@
+// ======================================================================
+// FILE:        GuessTraining.cpp
+//
+// DESCRIPTION: This file contains the guess model training. See
+//              GuessTraining.hpp.
+// ======================================================================
+
+#include "GuessTraining.hpp"
+#include "GuessModel.hpp"
+#include "GameTrace.hpp"
+#include "MyAI.hpp"
+#include "World.hpp"
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+// Newton steps at most, and the L2 weight
+#define GUESS_TRAIN_ITERATIONS 30
+#define GUESS_TRAIN_L2 1e-3
+
+namespace {
+
+struct GuessSamples {
+    vector<float> features;     // GUESS_FEATURES per sample
+    vector<char> mines;
+    size_t size() const { return mines.size(); }
+};
+
+// True if a numbered neighbor of c already says whether c is a mine
+bool decided(BoardRep& board, const Coord& c)
+{
+    for (int x = c.x-1; x <= c.x+1; ++x) {
+        for (int y = c.y-1; y <= c.y+1; ++y) {
+            if (!board.withinBounds(x, y) || board.getSquare(x, y) < 0) {
+                continue;
+            }
+            int need = board.getSquare(x, y), covered = 0;
+            for (int i = x-1; i <= x+1; ++i) {
+                for (int j = y-1; j <= y+1; ++j) {
+                    if (board.withinBounds(i, j)) {
+                        need -= board.getSquare(i, j) == FLAGGED;
+                        covered += board.getSquare(i, j) == COVERED;
+                    }
+                }
+            }
+            if (need == 0 || need == covered) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Replays a game from its trace through MyAI, sampling the undecided
+// squares of its frontier whenever it uncovers. Stops where the replay
+// leaves the trace.
+void sampleGame(const GameTrace& game, const WorldLayout& layout, MyAI*& agent, GuessSamples& samples)
+{
+    if (agent) {
+        agent->reset(game.rows, game.cols, game.mines, game.startX, game.startY);
+    } else {
+        agent = new MyAI(game.rows, game.cols, game.mines, game.startX, game.startY);
+    }
+
+    vector<Agent::Reveal> batch;
+    const Agent::Reveal* reveal = game.reveals.data();
+    float f[GUESS_FEATURES];
+    for (const TraceMove& move : game.moves) {
+        batch.assign(reveal, reveal + move.reveals);
+        reveal += move.reveals;
+        if (!batch.empty()) {
+            agent->revealed(batch);
+        }
+        Agent::Action action = agent->getAction(move.percept);
+        if (action.action != move.action.action || action.x != move.action.x || action.y != move.action.y) {
+            return;
+        }
+        if (action.action != Agent::UNCOVER) {
+            continue;
+        }
+
+        BoardRep& board = *agent->boardObj;
+        double density = agent->mine_density();
+        for (const Coord& c : board.frontier_covered) {
+            if (board.getSquare(c.x, c.y) != COVERED || decided(board, c)) {
+                continue;
+            }
+            guessFeatures(board, c, density, f);
+            samples.features.insert(samples.features.end(), f, f + GUESS_FEATURES);
+            samples.mines.push_back(layout.mines[(size_t) c.x * layout.rows + c.y]);
+        }
+    }
+}
+
+// Solves a x = b in place by Gaussian elimination with partial pivoting
+bool solveLinear(vector<double>& a, vector<double>& b, int n)
+{
+    for (int col = 0; col < n; ++col) {
+        int pivot = col;
+        for (int row = col + 1; row < n; ++row) {
+            if (fabs(a[row * n + col]) > fabs(a[pivot * n + col])) {
+                pivot = row;
+            }
+        }
+        if (fabs(a[pivot * n + col]) < 1e-12) {
+            return false;
+        }
+        for (int k = 0; k < n; ++k) {
+            swap(a[col * n + k], a[pivot * n + k]);
+        }
+        swap(b[col], b[pivot]);
+        for (int row = col + 1; row < n; ++row) {
+            double factor = a[row * n + col] / a[col * n + col];
+            for (int k = col; k < n; ++k) {
+                a[row * n + k] -= factor * a[col * n + k];
+            }
+            b[row] -= factor * b[col];
+        }
+    }
+    for (int row = n - 1; row >= 0; --row) {
+        for (int k = row + 1; k < n; ++k) {
+            b[row] -= a[row * n + k] * b[k];
+        }
+        b[row] /= a[row * n + row];
+    }
+    return true;
+}
+
+// Mean log loss of the weights over the samples
+double logLoss(const GuessSamples& samples, const vector<double>& w)
+{
+    double loss = 0;
+    for (size_t s = 0; s < samples.size(); ++s) {
+        const float* x = &samples.features[s * GUESS_FEATURES];
+        double z = 0;
+        for (int i = 0; i < GUESS_FEATURES; ++i) {
+            z += w[i] * x[i];
+        }
+        double p = 1 / (1 + exp(-z));
+        p = min(max(p, 1e-12), 1 - 1e-12);
+        loss -= samples.mines[s] ? log(p) : log(1 - p);
+    }
+    return loss / samples.size();
+}
+
+void fit(const GuessSamples& samples, vector<double>& w)
+{
+    const int n = GUESS_FEATURES;
+    w.assign(n, 0);
+    vector<double> gradient(n), hessian(n * n);
+    for (int iteration = 0; iteration < GUESS_TRAIN_ITERATIONS; ++iteration) {
+        fill(gradient.begin(), gradient.end(), 0);
+        fill(hessian.begin(), hessian.end(), 0);
+        for (size_t s = 0; s < samples.size(); ++s) {
+            const float* x = &samples.features[s * n];
+            double z = 0;
+            for (int i = 0; i < n; ++i) {
+                z += w[i] * x[i];
+            }
+            double p = 1 / (1 + exp(-z));
+            double r = p - samples.mines[s], v = p * (1 - p);
+            for (int i = 0; i < n; ++i) {
+                gradient[i] += r * x[i];
+                for (int j = 0; j <= i; ++j) {
+                    hessian[i * n + j] += v * x[i] * x[j];
+                }
+            }
+        }
+        for (int i = 0; i < n; ++i) {
+            gradient[i] = gradient[i] / samples.size() + GUESS_TRAIN_L2 * w[i];
+            for (int j = 0; j <= i; ++j) {
+                hessian[i * n + j] /= samples.size();
+                hessian[j * n + i] = hessian[i * n + j];
+            }
+            hessian[i * n + i] += GUESS_TRAIN_L2;
+        }
+        if (!solveLinear(hessian, gradient, n)) {
+            return;
+        }
+        double step = 0;
+        for (int i = 0; i < n; ++i) {
+            w[i] -= gradient[i];
+            step = max(step, fabs(gradient[i]));
+        }
+        if (step < 1e-7) {
+            return;
+        }
+    }
+}
+
+bool writeWeights(const string& filename, const vector<double>& w, size_t samples, int games, double loss)
+{
+    ofstream file(filename);
+    file << "// ======================================================================\n"
+         << "// FILE:        GuessWeights.hpp\n"
+         << "//\n"
+         << "// DESCRIPTION: Weights of the guess model (GuessModel.hpp), written by\n"
+         << "//              --train-guess. Don't edit; train again instead.\n"
+         << "//\n"
+         << "// NOTES:       - Fitted to " << samples << " frontier squares of " << games << " games,\n"
+         << "//                log loss " << loss << ".\n"
+         << "// ======================================================================\n"
+         << "\n"
+         << "#ifndef MINE_SWEEPER_CPP_SHELL_GUESSWEIGHTS_HPP\n"
+         << "#define MINE_SWEEPER_CPP_SHELL_GUESSWEIGHTS_HPP\n"
+         << "\n"
+         << "static const float GUESS_WEIGHTS[GUESS_FEATURES] = {\n";
+    char value[32];
+    for (int i = 0; i < GUESS_FEATURES; ++i) {
+        snprintf(value, sizeof value, "%.8g", w[i]);
+        string literal = value;
+        if (literal.find_first_of(".e") == string::npos) {
+            literal += ".0";
+        }
+        literal += "f";
+        file << (i % 4 ? " " : "    ") << literal << (i + 1 < GUESS_FEATURES ? "," : "") << (i % 4 == 3 ? "\n" : "");
+    }
+    file << "};\n"
+         << "\n"
+         << "#endif //MINE_SWEEPER_CPP_SHELL_GUESSWEIGHTS_HPP\n";
+    return (bool) file;
+}
+
+}
+
+bool trainGuessModel(const string& traceFile, const string& weightsFile, ostream& out)
+{
+    TraceReader reader;
+    if (!reader.open(traceFile)) {
+        return false;
+    }
+    GameTrace game;
+    WorldLayout layout;
+    GuessSamples samples;
+    MyAI* agent = nullptr;
+    int games = 0, skipped = 0;
+    while (reader.next(game)) {
+        if (game.world.empty() || !layout.load(game.world) || layout.rows != game.rows || layout.cols != game.cols) {
+            ++skipped;
+            continue;
+        }
+        sampleGame(game, layout, agent, samples);
+        ++games;
+    }
+    delete agent;
+    out << "Games: " << games << " (" << skipped << " skipped: random worlds or missing world files)" << endl;
+    out << "Samples: " << samples.size() << endl;
+    if (!samples.size()) {
+        return false;
+    }
+
+    // the density alone, for comparison
+    double density = 0;
+    for (char mine : samples.mines) {
+        density += mine;
+    }
+    density /= samples.size();
+    double baseline = -(density * log(density) + (1 - density) * log(1 - density));
+
+    vector<double> w;
+    fit(samples, w);
+    double loss = logLoss(samples, w);
+    out << "Log loss: " << loss << " (" << baseline << " guessing the mean " << density << ")" << endl;
+    if (!writeWeights(weightsFile, w, samples.size(), games, loss)) {
+        return false;
+    }
+    out << "Weights written to " << weightsFile << endl;
+    return true;
+}
@@ -0,0 +1,35 @@
+// ======================================================================
+// FILE:        GuessTraining.hpp
+//
+// DESCRIPTION: This file contains the offline training of the guess model
+//              (GuessModel.hpp) from recorded games.
+//
+// NOTES:       - The games come from a trace file (--trace, GameTrace.hpp)
+//                of worlds read from files; the world file says where the
+//                mines were. Games on random worlds are skipped.
+//
+//              - Each game is replayed through MyAI, so the features are
+//                taken from MyAI's own board, with the mines it knows
+//                flagged, as they will be when the model is used. Every
+//                time it uncovers, the frontier squares no single number
+//                decides become samples: their features, labelled by
+//                whether the world has a mine there. A game whose replay
+//                leaves the trace is cut off there.
+//
+//              - The model is fitted by Newton's method on the log loss,
+//                with a little L2 regularization, and written out as
+//                GuessWeights.hpp, to be compiled in.
+// ======================================================================
+
+#ifndef MINE_SWEEPER_CPP_SHELL_GUESSTRAINING_HPP
+#define MINE_SWEEPER_CPP_SHELL_GUESSTRAINING_HPP
+
+#include <iostream>
+#include <string>
+
+// Trains the guess model on the games in traceFile and writes its weights
+// to weightsFile, reporting the fit to out. Returns false if the trace
+// can't be read, holds no usable game, or weightsFile can't be written.
+bool trainGuessModel ( const std::string& traceFile, const std::string& weightsFile, std::ostream& out );
+
+#endif //MINE_SWEEPER_CPP_SHELL_GUESSTRAINING_HPP
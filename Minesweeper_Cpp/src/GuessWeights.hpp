@@ -0,0 +1,21 @@
+// ======================================================================
+// FILE:        GuessWeights.hpp
+//
+// DESCRIPTION: Weights of the guess model (GuessModel.hpp), written by
+//              --train-guess. Don't edit; train again instead.
+//
+// NOTES:       - Fitted to 6227819 frontier squares of 1500 games,
+//                log loss 0.50616.
+// ======================================================================
+
+#ifndef MINE_SWEEPER_CPP_SHELL_GUESSWEIGHTS_HPP
+#define MINE_SWEEPER_CPP_SHELL_GUESSWEIGHTS_HPP
+
+static const float GUESS_WEIGHTS[GUESS_FEATURES] = {
+    -1.5332341f, -0.27770236f, -0.33616066f, -0.61772799f,
+    0.12488929f, -0.70423476f, 0.90865314f, 0.90999917f,
+    1.2290505f, 1.4634944f, 0.40719683f, -2.7524985f,
+    0.090418864f, -1.0322333f, 1.0959749f, 1.7671425f
+};
+
+#endif //MINE_SWEEPER_CPP_SHELL_GUESSWEIGHTS_HPP
@@ -0,0 +1,237 @@
+// ======================================================================
+// FILE:        LockstepSim.cpp
+//
+// DESCRIPTION: This file contains the lockstep simulator and its
+//              benchmark against World. See LockstepSim.hpp.
+// ======================================================================
+
+#include "LockstepSim.hpp"
+#include "World.hpp"
+#include <chrono>
+#include <climits>
+#include <iomanip>
+
+namespace {
+
+inline uint32_t xorshift(uint32_t& state)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+// A random integer in [0, limit) from 32 random bits
+inline int32_t below(uint32_t bits, int32_t limit)
+{
+    return (int32_t) (((uint64_t) bits * (uint32_t) limit) >> 32);
+}
+
+}
+
+LockstepSim::LockstepSim(int _rows, int _cols, int _mines, unsigned seed)
+    : rows(_rows), cols(_cols), mines(_mines), squares(_rows * _cols)
+{
+    maxMoves = (int) min(2LL * rows * cols, (long long) INT_MAX);
+    // World::reset's bonus by difficulty
+    bonus = cols == 16 ? 2 : cols == 30 ? 3 : 1;
+
+    mine.assign(squares * LOCKSTEP_LANES, 0);
+    number.assign(squares * LOCKSTEP_LANES, 0);
+    uncovered.assign(squares * LOCKSTEP_LANES, 0);
+    flag.assign(squares * LOCKSTEP_LANES, 0);
+
+    // xorshift must not start at 0
+    for (int g = 0; g < LOCKSTEP_LANES; ++g) {
+        rng[g] = (seed + 1) * 2654435761u + g * 40503u;
+        if (!rng[g]) {
+            rng[g] = 1;
+        }
+    }
+}
+
+void LockstepSim::play(LockstepTotals& totals)
+{
+    startGames();
+    placeMines();
+    countNumbers();
+    while (step()) {
+    }
+    for (int g = 0; g < LOCKSTEP_LANES; ++g) {
+        totals.moves += moves[g];
+        totals.score += score[g];
+    }
+    totals.games += LOCKSTEP_LANES;
+}
+
+// genFirstAxis and the start of World::reset, for every lane
+void LockstepSim::startGames()
+{
+    fill(uncovered.begin(), uncovered.end(), 0);
+    fill(flag.begin(), flag.end(), 0);
+    for (int g = 0; g < LOCKSTEP_LANES; ++g) {
+        startCol[g] = below(xorshift(rng[g]), cols);
+        startRow[g] = below(xorshift(rng[g]), rows);
+        covered[g] = squares - 1;
+        flagLeft[g] = mines;
+        correctFlags[g] = 0;
+        score[g] = 0;
+        moves[g] = 0;
+        running[g] = 1;
+    }
+    for (int g = 0; g < LOCKSTEP_LANES; ++g) {
+        uncovered[(startCol[g] * rows + startRow[g]) * LOCKSTEP_LANES + g] = 1;
+    }
+}
+
+void LockstepSim::placeMines()
+{
+    int32_t squaresLeft[LOCKSTEP_LANES];
+    int32_t minesLeft[LOCKSTEP_LANES];
+    for (int g = 0; g < LOCKSTEP_LANES; ++g) {
+        // the start patch is smaller at an edge
+        int patchCols = min(startCol[g] + 1, cols - 1) - max(startCol[g] - 1, 0) + 1;
+        int patchRows = min(startRow[g] + 1, rows - 1) - max(startRow[g] - 1, 0) + 1;
+        squaresLeft[g] = squares - patchCols * patchRows;
+        minesLeft[g] = mines;
+    }
+
+    // the draw is kept apart from the byte stores, so each loop works on
+    // lanes of one width
+    int32_t take[LOCKSTEP_LANES];
+    for (int c = 0; c < cols; ++c) {
+        for (int r = 0; r < rows; ++r) {
+            for (int g = 0; g < LOCKSTEP_LANES; ++g) {
+                int32_t open = (abs(c - startCol[g]) > 1) | (abs(r - startRow[g]) > 1);
+                take[g] = open & (below(xorshift(rng[g]), squaresLeft[g]) < minesLeft[g]);
+                minesLeft[g] -= take[g];
+                squaresLeft[g] -= open;
+            }
+            copy(take, take + LOCKSTEP_LANES, &mine[(c * rows + r) * LOCKSTEP_LANES]);
+        }
+    }
+}
+
+// addMineCount across the lanes: each square's count is the sum of its
+// neighbors' mine bytes, a lane-wise add per neighbor (into a local array,
+// which the compiler knows can't overlap the board)
+void LockstepSim::countNumbers()
+{
+    uint8_t count[LOCKSTEP_LANES];
+    for (int c = 0; c < cols; ++c) {
+        for (int r = 0; r < rows; ++r) {
+            for (int g = 0; g < LOCKSTEP_LANES; ++g) {
+                count[g] = 0;
+            }
+            for (int nc = max(c - 1, 0); nc <= min(c + 1, cols - 1); ++nc) {
+                for (int nr = max(r - 1, 0); nr <= min(r + 1, rows - 1); ++nr) {
+                    if (nc == c && nr == r) {
+                        continue;
+                    }
+                    const uint8_t* neighbor = &mine[(nc * rows + nr) * LOCKSTEP_LANES];
+                    for (int g = 0; g < LOCKSTEP_LANES; ++g) {
+                        count[g] += neighbor[g];
+                    }
+                }
+            }
+            copy(count, count + LOCKSTEP_LANES, &number[(c * rows + r) * LOCKSTEP_LANES]);
+        }
+    }
+}
+
+// RandomAI's choice and World::doMove in every running lane, written
+// without branches on the action so the lanes stay in step
+bool LockstepSim::step()
+{
+    int32_t action[LOCKSTEP_LANES];
+    int32_t index[LOCKSTEP_LANES];
+    for (int g = 0; g < LOCKSTEP_LANES; ++g) {
+        action[g] = below(xorshift(rng[g]), 4);
+        int32_t x = below(xorshift(rng[g]), cols);
+        int32_t y = below(xorshift(rng[g]), rows);
+        index[g] = (x * rows + y) * LOCKSTEP_LANES + g;
+    }
+
+    int32_t left = 0;
+    for (int g = 0; g < LOCKSTEP_LANES; ++g) {
+        int32_t live = running[g];
+        int32_t isMine = mine[index[g]];
+        int32_t wasUncovered = uncovered[index[g]];
+        int32_t wasFlagged = flag[index[g]];
+
+        int32_t leave = live & (action[g] == Agent::LEAVE);
+        int32_t uncover = live & (action[g] == Agent::UNCOVER);
+        int32_t flagged = live & (action[g] == Agent::FLAG) & (flagLeft[g] != 0);
+        int32_t unflagged = live & (action[g] == Agent::UNFLAG) & wasFlagged;
+        int32_t opened = uncover & !isMine & !wasUncovered;
+
+        score[g] += (leave & (covered[g] == mines)) ? bonus : 0;
+        covered[g] -= opened;
+        uncovered[index[g]] = (uint8_t) (wasUncovered | opened);
+        flag[index[g]] = (uint8_t) ((wasFlagged | flagged) & !unflagged);
+        flagLeft[g] += unflagged - flagged;
+        correctFlags[g] += (flagged - unflagged) * (isMine ? 1 : -1);
+        moves[g] += live;
+
+        int32_t over = leave | (uncover & isMine) | (moves[g] >= maxMoves);
+        running[g] = (uint8_t) (live & !over);
+        left += running[g];
+    }
+    return left > 0;
+}
+
+// ===============================================================
+// =                        Benchmark
+// ===============================================================
+
+namespace {
+
+void reportLine(ostream& out, const char* name, const LockstepTotals& totals)
+{
+    out << left << setw(12) << name << right << setw(12) << totals.games << fixed << setprecision(3)
+        << setw(12) << totals.seconds << setprecision(0) << setw(14) << totals.games / totals.seconds
+        << setprecision(3) << setw(12) << (double) totals.moves / totals.games
+        << setprecision(4) << setw(12) << (double) totals.score / totals.games << endl;
+}
+
+}
+
+bool runLockstepBenchmark(int rows, int cols, int mines, long long games, unsigned seed, ostream& out)
+{
+    if (rows < 4 || cols < 4 || mines < 1 || mines > rows * cols - 9 || games < 1) {
+        return false;
+    }
+
+    out << left << setw(12) << "engine" << right << setw(12) << "games" << setw(12) << "seconds"
+        << setw(14) << "games/s" << setw(12) << "moves/game" << setw(12) << "score/game" << endl;
+
+    LockstepSim sim(rows, cols, mines, seed);
+    LockstepTotals lockstep;
+    auto start = chrono::steady_clock::now();
+    while (lockstep.games < games) {
+        sim.play(lockstep);
+    }
+    lockstep.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    reportLine(out, "lockstep", lockstep);
+
+    // World only generates random boards of 8x8 with 10 mines
+    if (rows != 8 || cols != 8 || mines != 10) {
+        out << "(World only generates 8x8 boards with 10 mines; no scalar comparison)" << endl;
+        return true;
+    }
+    srand(seed);
+    World world(false, "randomAI", string());
+    LockstepTotals scalar;
+    start = chrono::steady_clock::now();
+    for (; scalar.games < lockstep.games; ++scalar.games) {
+        if (scalar.games) {
+            world.reset(string());
+        }
+        scalar.score += world.run();
+        scalar.moves += world.moves();
+    }
+    scalar.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    reportLine(out, "World", scalar);
+    out << "speedup: " << fixed << setprecision(1) << (lockstep.games / lockstep.seconds) / (scalar.games / scalar.seconds) << "x" << endl;
+    return true;
+}
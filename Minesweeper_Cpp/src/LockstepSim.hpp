@@ -0,0 +1,92 @@
+// ======================================================================
+// FILE:        LockstepSim.hpp
+//
+// DESCRIPTION: This file contains the lockstep simulator: many games of
+//              an agent-free baseline played at once, for throughput
+//              studies that don't need World's agent interface.
+//
+// NOTES:       - A batch is LOCKSTEP_LANES games of the same size. Every
+//                square is stored once per game, side by side
+//                ([square * LOCKSTEP_LANES + game]), and every per-game
+//                value is an array over the games, so each phase is a
+//                loop across the lanes that the compiler can vectorize:
+//                mine placement, neighbor counting, the policy's choice
+//                and the move.
+//
+//              - Mines are placed by selection sampling: the squares are
+//                visited in order, and each lane takes a square with
+//                probability (mines left) / (squares left), outside the
+//                3x3 patch around its start. Every lane gets exactly the
+//                board's mine count, uniformly placed, like World.
+//
+//              - The policy is RandomAI's: a uniformly random action on a
+//                uniformly random square. Moves follow World::doMove
+//                exactly, including its quirks (flagging a flagged or
+//                uncovered square uses a flag; uncovering a flagged square
+//                uncovers it), as do the move limit and the bonus.
+//
+//              - Each lane has its own xorshift generator, so the games
+//                are independent of one another and of rand().
+// ======================================================================
+
+#ifndef MINE_SWEEPER_CPP_SHELL_LOCKSTEPSIM_HPP
+#define MINE_SWEEPER_CPP_SHELL_LOCKSTEPSIM_HPP
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+#define LOCKSTEP_LANES 32
+
+struct LockstepTotals {
+    long long games = 0;
+    long long moves = 0;
+    long long score = 0;
+    double seconds = 0;
+};
+
+class LockstepSim
+{
+public:
+    LockstepSim ( int rows, int cols, int mines, unsigned seed );
+
+    // Plays one batch of LOCKSTEP_LANES games to the end
+    void play ( LockstepTotals& totals );
+
+private:
+    void startGames ();
+    void placeMines ();
+    void countNumbers ();
+    bool step ();               // one move in every running game; false when none is left
+
+    int rows, cols, mines, squares;
+    int maxMoves;
+    int bonus;
+
+    // per square and lane; squares are column-major like World's tiles
+    vector<uint8_t> mine;
+    vector<uint8_t> number;
+    vector<uint8_t> uncovered;
+    vector<uint8_t> flag;
+
+    // per lane
+    uint32_t rng[LOCKSTEP_LANES];
+    int32_t startCol[LOCKSTEP_LANES];
+    int32_t startRow[LOCKSTEP_LANES];
+    int32_t covered[LOCKSTEP_LANES];
+    int32_t flagLeft[LOCKSTEP_LANES];
+    int32_t correctFlags[LOCKSTEP_LANES];
+    int32_t score[LOCKSTEP_LANES];
+    int32_t moves[LOCKSTEP_LANES];
+    uint8_t running[LOCKSTEP_LANES];
+};
+
+// Plays 'games' random-policy games in lockstep and, for the 8x8 board
+// World generates, as many through World and RandomAI, and reports games
+// per second, moves per game and score per game of both. Returns false
+// for an invalid board.
+bool runLockstepBenchmark ( int rows, int cols, int mines, long long games, unsigned seed, ostream& out );
+
+#endif //MINE_SWEEPER_CPP_SHELL_LOCKSTEPSIM_HPP
@@ -0,0 +1,268 @@
+// ======================================================================
+// FILE:        Lookahead.cpp
+//
+// DESCRIPTION: This file contains the guess lookahead. See Lookahead.hpp.
+// ======================================================================
+
+#include "Lookahead.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <atomic>
+
+Lookahead& Lookahead::shared()
+{
+    static Lookahead lookahead;
+    return lookahead;
+}
+
+Lookahead::~Lookahead()
+{
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        pool_stopping = true;
+    }
+    pool_wake.notify_all();
+    for (std::thread& t : pool)
+        t.join();
+}
+
+// Pool threads sleep between rounds; those past pool_helpers sit a round out
+void Lookahead::poolThread(int id)
+{
+    unsigned long long seen = 0;
+    std::unique_lock<std::mutex> lock(pool_mutex);
+    for (;;) {
+        pool_wake.wait(lock, [&]() { return pool_stopping || pool_round != seen; });
+        if (pool_stopping)
+            return;
+        seen = pool_round;
+        if (id >= pool_helpers)
+            continue;
+        const std::function<void()>& job = *pool_job;
+        lock.unlock();
+        job();
+        lock.lock();
+        if (--pool_pending == 0)
+            pool_done.notify_one();
+    }
+}
+
+void Lookahead::run(int helpers, const std::function<void()>& job)
+{
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex);
+        while ((int) pool.size() < helpers) {
+            int id = pool.size();
+            pool.emplace_back([this, id]() { poolThread(id); });
+        }
+        pool_job = &job;
+        pool_helpers = helpers;
+        pool_pending = helpers;
+        ++pool_round;
+    }
+    pool_wake.notify_all();
+    job();
+    std::unique_lock<std::mutex> lock(pool_mutex);
+    pool_done.wait(lock, [&]() { return pool_pending == 0; });
+    pool_job = nullptr;
+}
+
+// Finds the component holding square c
+bool Lookahead::locate(const vector<FrontierComponent>& components, const Coord& c, int& component, int& index) const
+{
+    for (size_t k = 0; k < components.size(); ++k) {
+        const vector<Coord>& cells = components[k].cells;
+        auto it = find(cells.begin(), cells.end(), c);
+        if (it != cells.end()) {
+            component = k;
+            index = it - cells.begin();
+            return true;
+        }
+    }
+    return false;
+}
+
+// Merges the candidate's component with the components of its covered
+// neighbors, and adds its neighbors off the frontier. Returns false if the
+// result is too big to score.
+bool Lookahead::build(BoardRep& board, const vector<FrontierComponent>& components, int component,
+                      double density, Candidate& candidate)
+{
+    const Coord& c = candidate.square;
+    merged.assign(1, component);
+    vector<Coord> interior;
+    for (int i = c.x-1; i <= c.x+1; ++i) {
+        for (int j = c.y-1; j <= c.y+1; ++j) {
+            if ((i == c.x && j == c.y) || board.getSquare(i, j) != COVERED)
+                continue;
+            int k, index;
+            if (!locate(components, Coord(i, j), k, index))
+                interior.push_back(Coord(i, j));
+            else if (find(merged.begin(), merged.end(), k) == merged.end())
+                merged.push_back(k);
+        }
+    }
+
+    size_t size = interior.size();
+    for (int k : merged)
+        size += components[k].cells.size();
+    if (size > LOOKAHEAD_MAX_CELLS)
+        return false;
+
+    FrontierComponent& system = candidate.system;
+    system = FrontierComponent();
+    for (int k : merged) {
+        const FrontierComponent& comp = components[k];
+        int offset = system.cells.size();
+        system.cells.insert(system.cells.end(), comp.cells.begin(), comp.cells.end());
+        system.numbers.insert(system.numbers.end(), comp.numbers.begin(), comp.numbers.end());
+        for (Constraint constraint : comp.constraints) {
+            for (int& cell : constraint.cells)
+                cell += offset;
+            system.constraints.push_back(constraint);
+        }
+        system.truncated |= comp.truncated;
+    }
+    system.mine_odds.assign(system.cells.size(), 1);
+    for (const Coord& e : interior) {
+        system.cells.push_back(e);
+        system.mine_odds.push_back(density / (1 - density));
+    }
+
+    candidate.index = find(system.cells.begin(), system.cells.end(), c) - system.cells.begin();
+    candidate.reveal = Constraint();
+    candidate.reveal.slack = 0;
+    for (int i = c.x-1; i <= c.x+1; ++i) {
+        for (int j = c.y-1; j <= c.y+1; ++j) {
+            auto it = find(system.cells.begin(), system.cells.end(), Coord(i, j));
+            if ((i != c.x || j != c.y) && it != system.cells.end())
+                candidate.reveal.cells.push_back(it - system.cells.begin());
+        }
+    }
+    return true;
+}
+
+// Solves the candidate's system once per number it could show. Leaves
+// progress at -1 if the deadline passed first.
+void Lookahead::score(Candidate& candidate, std::chrono::steady_clock::time_point deadline)
+{
+    FrontierComponent& system = candidate.system;
+    Constraint safe;
+    safe.mines = 0;
+    safe.slack = 0;
+    safe.cells.push_back(candidate.index);
+    system.constraints.push_back(safe);
+    system.constraints.push_back(candidate.reveal);
+    system.numbers.push_back(candidate.square);
+    system.numbers.push_back(candidate.square);
+    Constraint& reveal = system.constraints.back();
+
+    ComponentSolution solution;
+    double weight = 0;
+    double proven = 0;
+    bool finished = true;
+    for (int n = 0; n <= (int) reveal.cells.size(); ++n) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            finished = false;
+            break;
+        }
+        reveal.mines = n;
+        if (!solveComponent(system, solution))
+            continue;
+        int safe_squares = 0;
+        for (size_t i = 0; i < system.cells.size(); ++i) {
+            if ((int) i != candidate.index && solution.mine_counts[i] == 0)
+                ++safe_squares;
+        }
+        weight += solution.total;
+        proven += solution.total * safe_squares;
+    }
+
+    system.constraints.resize(system.constraints.size() - 2);
+    system.numbers.resize(system.numbers.size() - 2);
+    if (finished && weight > 0)
+        candidate.progress = proven / weight;
+}
+
+bool Lookahead::choose(BoardRep& board, const vector<FrontierComponent>& components,
+                       const vector<ComponentSolution>& solutions, double density, Coord& guess)
+{
+    ProfileScope profile(PROFILE_LOOKAHEAD);
+    int component, index;
+    if (!locate(components, guess, component, index) || !solutions[component].total)
+        return false;
+    ++guesses;
+    density = min(max(density, 0.0), 0.99);
+
+    // every other square of the solved components, least risky first
+    struct Ranked {
+        double risk;
+        int component;
+        int index;
+    };
+    vector<Ranked> order;
+    double lowest = 1;
+    for (size_t k = 0; k < components.size(); ++k) {
+        const ComponentSolution& solution = solutions[k];
+        if (!solution.total)
+            continue;
+        for (size_t i = 0; i < components[k].cells.size(); ++i) {
+            double risk = solution.mine_counts[i] / solution.total;
+            lowest = min(lowest, risk);
+            if ((int) k != component || (int) i != index)
+                order.push_back({risk, (int) k, (int) i});
+        }
+    }
+    stable_sort(order.begin(), order.end(), [](const Ranked& a, const Ranked& b) { return a.risk < b.risk; });
+
+    // the guess comes first, so it wins ties
+    ranked.resize(1);
+    ranked[0].square = guess;
+    ranked[0].risk = solutions[component].mine_counts[index] / solutions[component].total;
+    ranked[0].progress = -1;
+    vector<int> sources(1, component);
+    for (const Ranked& r : order) {
+        if ((int) ranked.size() >= candidates || r.risk > lowest + LOOKAHEAD_RISK_SLACK)
+            break;
+        ranked.emplace_back();
+        ranked.back().square = components[r.component].cells[r.index];
+        ranked.back().risk = r.risk;
+        sources.push_back(r.component);
+    }
+    if (ranked.size() == 1)
+        return false;
+
+    vector<Candidate*> work;
+    for (size_t k = 0; k < ranked.size(); ++k) {
+        ranked[k].progress = -1;
+        if (build(board, components, sources[k], density, ranked[k]))
+            work.push_back(&ranked[k]);
+    }
+
+    // one candidate per thread at a time, this thread included
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(LOOKAHEAD_BUDGET_MS);
+    std::atomic<size_t> next(0);
+    std::function<void()> worker = [&]() {
+        for (size_t k; (k = next++) < work.size(); )
+            score(*work[k], deadline);
+    };
+    int count = threads > 0 ? threads : max(1u, std::thread::hardware_concurrency());
+    run(max(min<int>(count, work.size()) - 1, 0), worker);
+
+    if (ranked[0].progress < 0)
+        return false;
+    size_t best = 0;
+    double best_value = (1 - ranked[0].risk) * (1 + ranked[0].progress);
+    for (size_t k = 1; k < ranked.size(); ++k) {
+        double value = (1 - ranked[k].risk) * (1 + ranked[k].progress);
+        if (ranked[k].progress >= 0 && value > best_value) {
+            best = k;
+            best_value = value;
+        }
+    }
+    if (!best)
+        return false;
+    guess = ranked[best].square;
+    ++changed;
+    return true;
+}
@@ -0,0 +1,117 @@
+// ======================================================================
+// FILE:        Lookahead.hpp
+//
+// DESCRIPTION: This file contains the guess lookahead. When MyAI has to
+//              guess, the few squares least likely to be mines are
+//              compared by what their numbers would likely reveal, and
+//              the guess goes to the one expected to open up the most.
+//
+// NOTES:       - A candidate is scored by simulating every number it
+//                could show. Its component and the components around it
+//                are merged into one constraint system, its covered
+//                neighbors off the frontier are added as squares weighted
+//                by the mine density, and for each number n the system
+//                gets two more constraints: the candidate is safe, and n
+//                mines surround it. Solving it gives the chance of n and
+//                the squares n would prove safe.
+//
+//              - Each candidate's system is its own snapshot: the board,
+//                the components and their solutions are only read, and
+//                the per-number constraints are pushed onto and popped
+//                off the candidate's copy. So candidates are scored in
+//                parallel, one per thread, with no locking. The threads
+//                are a small pool started on the first guess and reused
+//                for the rest of the run.
+//
+//              - Only squares as safe as the safest one compete, so a
+//                guess is never traded for a riskier one. Among them the
+//                score is the expected number of squares gained: the
+//                chance the square is safe times one plus the safe
+//                squares its number proves.
+//
+//              - Scoring stops at LOOKAHEAD_BUDGET_MS; candidates not
+//                finished by then are left out. The original guess is
+//                kept unless it was scored and another beat it.
+// ======================================================================
+
+#ifndef MINE_SWEEPER_CPP_SHELL_LOOKAHEAD_HPP
+#define MINE_SWEEPER_CPP_SHELL_LOOKAHEAD_HPP
+
+#include "Frontier.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// Most squares compared per guess, the original guess included; only
+// squares as safe as the safest one are compared, so often fewer
+#define LOOKAHEAD_CANDIDATES 8
+
+// Most squares in a candidate's merged system
+#define LOOKAHEAD_MAX_CELLS 24
+
+// Risks closer than this to the lowest count as the lowest
+#define LOOKAHEAD_RISK_SLACK 1e-9
+
+#define LOOKAHEAD_BUDGET_MS 50
+
+class Lookahead
+{
+public:
+    // The lookahead MyAI consults; off unless Main enables it
+    static Lookahead& shared();
+
+    ~Lookahead();
+
+    bool enabled = false;
+    int candidates = LOOKAHEAD_CANDIDATES;  // most equally safe squares compared
+    int threads = 0;            // scoring threads; 0 for one per core
+
+    // Compares guess with the other low-risk squares of the solved
+    // components (solutions[k] solves components[k]; a total of 0 marks
+    // one left unsolved) and replaces it with the best. density is the
+    // chance a square off the frontier is a mine. Returns true if the
+    // guess changed.
+    bool choose ( BoardRep& board, const vector<FrontierComponent>& components,
+                  const vector<ComponentSolution>& solutions, double density, Coord& guess );
+
+    // Statistics
+    long long guesses = 0;      // calls with the guess found in a solved component
+    long long changed = 0;      // guesses replaced
+
+private:
+    struct Candidate {
+        Coord square;
+        double risk = 0;                // chance it is a mine
+        double progress = -1;           // expected safe squares its number proves, -1 if not scored
+        FrontierComponent system;       // merged constraint system around it
+        int index = 0;                  // the candidate in system.cells
+        Constraint reveal;              // its number, less its flagged neighbors
+    };
+
+    bool locate ( const vector<FrontierComponent>& components, const Coord& c, int& component, int& index ) const;
+    bool build ( BoardRep& board, const vector<FrontierComponent>& components, int component, double density, Candidate& candidate );
+    void score ( Candidate& candidate, std::chrono::steady_clock::time_point deadline );
+
+    // Runs job on this thread and on 'helpers' pool threads, and returns
+    // once all of them have
+    void run ( int helpers, const std::function<void()>& job );
+    void poolThread ( int id );
+
+    vector<Candidate> ranked;
+    vector<int> merged;         // components in the candidate being built
+
+    // scoring threads, kept between guesses
+    vector<std::thread> pool;
+    std::mutex pool_mutex;
+    std::condition_variable pool_wake;
+    std::condition_variable pool_done;
+    const std::function<void()>* pool_job = nullptr;
+    unsigned long long pool_round = 0;  // bumped for each job
+    int pool_helpers = 0;               // pool threads taking part in this round
+    int pool_pending = 0;               // of those, the ones still running
+    bool pool_stopping = false;
+};
+
+#endif //MINE_SWEEPER_CPP_SHELL_LOOKAHEAD_HPP
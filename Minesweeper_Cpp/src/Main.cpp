@@ -39,26 +39,437 @@
 //
 //              - If -m and -r are turned on, -m will be turned off.
 //
+//              - Long options may appear anywhere on the command line:
+//
+//                  --patterns=FILE      Load a local pattern table that
+//                                       MyAI consults before enumerating.
+//                  --gen-patterns=FILE  Solve and record the pattern
+//                                       windows met during the run, then
+//                                       write them (plus any table loaded
+//                                       with --patterns) to FILE.
+//                  --component-db=FILE  Memory-map a store of solved
+//                                       frontier components at startup
+//                                       and write it back, with the
+//                                       components solved in this run,
+//                                       when the run ends.
+//                  --component-db-cap=N Keep at most N components in the
+//                                       store (default 1000000).
+//                  --cascade            Uncovering a zero uncovers its
+//                                       whole zero region and border in
+//                                       one move, for agents that accept
+//                                       the extra squares (MyAI does).
+//                  --agent=COMMAND      Play every game through an agent
+//                                       in another process, started once
+//                                       with /bin/sh -c COMMAND, over the
+//                                       pipe protocol in ExternalAgent.hpp.
+//                                       Overrides -m and -r.
+//                  --trace=FILE         Record every game played headless
+//                                       to FILE: percepts, actions and the
+//                                       agent's time on every move (see
+//                                       GameTrace.hpp).
+//                  --replay=FILE        Play the games recorded in FILE
+//                                       back through MyAI instead of
+//                                       running worlds, and report the
+//                                       time of every game and the
+//                                       slowest moves.
+//                  --replay-repeat=N    Replay every game N times and keep
+//                                       the fastest time of each move.
+//                  --verify=FILE        Check every solver engine MyAI runs
+//                                       against a reference enumeration,
+//                                       and the frontier sweep and the
+//                                       bit-sliced kernels against
+//                                       backtracking, and append
+//                                       mismatching positions to FILE
+//                                       (see Verifier.hpp).
+//                  --verify-replay=FILE Run the engines again on the
+//                                       positions dumped to FILE.
+//                  --train-guess=FILE   Fit the guess model MyAI falls back
+//                                       on when out of time to the games
+//                                       recorded in FILE (with --trace,
+//                                       on world files) and write its
+//                                       weights instead of running worlds
+//                                       (see GuessTraining.hpp).
+//                  --guess-weights=FILE Where --train-guess writes them
+//                                       (default GuessWeights.hpp); copy
+//                                       it to src/ and rebuild to use it.
+//                  --results=FILE       With -f on a folder, append a line
+//                                       per world to FILE as soon as it is
+//                                       played: outcome, score, moves,
+//                                       wall time and peak frontier (see
+//                                       ResultsLog.hpp). FILE is started
+//                                       over unless --resume is given.
+//                  --resume             Keep the worlds already in the
+//                                       --results file, play only the
+//                                       others, and count both in the
+//                                       totals.
+//                  --move-timeout=MS    Stop a game, scored 0 and recorded
+//                                       as a timeout, once one agent turn
+//                                       takes longer than MS milliseconds
+//                                       (see Watchdog.hpp).
+//                  --game-timeout=MS    The same for a whole game.
+//                  --timeout-grace=MS   Time a stopped agent gets to return
+//                                       before the game is forfeited and
+//                                       the run exits with status 3
+//                                       (default 1000); --resume then
+//                                       continues after that world.
+//                  --profile            Measure the game loop and MyAI's
+//                                       solver phases (hardware counters
+//                                       where available, time, allocations)
+//                                       and report them at the end (see
+//                                       Profiler.hpp).
+//                  --stress=FOLDER      Search for the worlds that cost
+//                                       MyAI the most and write them to
+//                                       FOLDER instead of running worlds
+//                                       (see StressSearch.hpp). Tuned by:
+//                  --stress-size=SIZE   beginner, intermediate, expert
+//                                       (default) or ROWSxCOLS:MINES.
+//                  --stress-iterations=N Candidate worlds to play
+//                                       (default 200).
+//                  --stress-keep=N      Worlds to write (default 10).
+//                  --stress-metric=M    nodes (default) or time.
+//                  --stress-seed=N      Seed of the search (default: the
+//                                       time).
+//                  --lockstep=N         Play N games of RandomAI's policy
+//                                       in the lockstep simulator, and as
+//                                       many through World, and report
+//                                       games per second of both instead
+//                                       of running worlds (see
+//                                       LockstepSim.hpp).
+//                  --lockstep-size=SIZE Board of the lockstep games, as for
+//                                       --stress-size (default beginner,
+//                                       the only size World compares on).
+//                  --lockstep-seed=N    Seed of the lockstep games.
+//                  --lookahead[=K]      When MyAI has to guess, compare up
+//                                       to K (default 8) equally safe
+//                                       squares, those tied for the lowest
+//                                       risk, by what their numbers would
+//                                       likely reveal, in parallel (see
+//                                       Lookahead.hpp).
+//                  --lookahead-threads=N Threads scoring the candidates
+//                                       (default: one per core).
+//                  --agents=LIST        With -f on a folder, play every
+//                                       world with each agent in the
+//                                       comma-separated LIST (MyAI,
+//                                       randomAI or the path of an agent
+//                                       plugin, see AgentPlugin.hpp) and
+//                                       report them side by side (see
+//                                       AgentComparison.hpp).
+//                  --ab=A,B             Play agents A and B (as in --agents)
+//                                       on the same seeded random worlds
+//                                       instead of running worlds, and
+//                                       report the paired win rate
+//                                       difference with its confidence
+//                                       interval and both agents' game
+//                                       times (see ABTest.hpp). Tuned by:
+//                  --ab-size=SIZE       Board, as for --stress-size
+//                                       (default expert).
+//                  --ab-games=N         Most worlds to play (default 2000).
+//                  --ab-check=N         Worlds between looks at the
+//                                       results (default 100).
+//                  --ab-confidence=C    Stop at the first look that is
+//                                       conclusive at confidence C
+//                                       (default 0.95).
+//                  --ab-margin=M        Also stop once the difference is
+//                                       within +-M (default 0.01; 0 never).
+//                  --ab-seed=N          Seed of the worlds (default: the
+//                                       time).
+//                  --watch[=MS]         Show the board after every move as
+//                                       -d does, but without waiting for
+//                                       ENTER; pause MS milliseconds
+//                                       between moves (default 0).
+//
 //              - Don't make changes to this file.
 // ======================================================================
 
 #include <iostream>
+#include <chrono>
 #include <dirent.h>
 #include <cmath>
+#include <cstring>
+#include <map>
 #include "World.hpp"
+#include "PatternTable.hpp"
+#include "ComponentCache.hpp"
+#include "GameTrace.hpp"
+#include "GuessTraining.hpp"
+#include "Verifier.hpp"
+#include "ResultsLog.hpp"
+#include "Profiler.hpp"
+#include "StressSearch.hpp"
+#include "LockstepSim.hpp"
+#include "Lookahead.hpp"
+#include "AgentComparison.hpp"
+#include "ABTest.hpp"
+#include "Watchdog.hpp"
 #include <sys/stat.h>
 
 
 using namespace std;
 
+// Removes every --name or --name=value argument from argv and returns them
+// as name -> value, so the classic positional parsing never sees them
+map<string, string> extractLongOptions( int& argc, char *argv[] )
+{
+    map<string, string> options;
+    int kept = 1;
+    for ( int index = 1; index < argc; ++index )
+    {
+        string arg = argv[index];
+        if ( arg.size() > 2 && arg[0] == '-' && arg[1] == '-' )
+        {
+            size_t eq = arg.find('=');
+            if ( eq == string::npos )
+                options[arg.substr(2)] = "";
+            else
+                options[arg.substr(2, eq - 2)] = arg.substr(eq + 1);
+        }
+        else
+            argv[kept++] = argv[index];
+    }
+    argc = kept;
+    return options;
+}
+
+// Splits a comma-separated list, dropping empty items
+vector<string> splitList( const string& list )
+{
+    vector<string> items;
+    size_t start = 0;
+    while ( start <= list.size() )
+    {
+        size_t comma = list.find( ',', start );
+        if ( comma == string::npos )
+            comma = list.size();
+        if ( comma > start )
+            items.push_back( list.substr( start, comma - start ) );
+        start = comma + 1;
+    }
+    return items;
+}
+
+// Reads beginner, intermediate, expert or ROWSxCOLS:MINES
+bool parseBoardSize( const string& size, int& rows, int& cols, int& mines )
+{
+    if ( size == "beginner" )
+        rows = 8, cols = 8, mines = 10;
+    else if ( size == "intermediate" )
+        rows = 16, cols = 16, mines = 40;
+    else if ( size == "expert" )
+        rows = 16, cols = 30, mines = 99;
+    else
+        return sscanf( size.c_str(), "%dx%d:%d", &rows, &cols, &mines ) == 3;
+    return true;
+}
+
+int runWorlds( int argc, char *argv[], const WorldOptions& worldOptions, ResultsLog* results );
+
 int main( int argc, char *argv[] )
+{
+    map<string, string> options = extractLongOptions( argc, argv );
+    // options[] below adds the names it looks up; plugins get the originals
+    const map<string, string> given = options;
+
+    PatternTable& patterns = PatternTable::shared();
+    if ( options.count("patterns") && !patterns.load( options["patterns"] ) )
+        cout << "[WARNING] Failed to load pattern table " << options["patterns"] << "." << endl;
+    patterns.recording = options.count("gen-patterns") > 0;
+
+    ComponentCache& components = ComponentCache::shared();
+    if ( options.count("component-db-cap") )
+        components.cap = atol( options["component-db-cap"].c_str() );
+    if ( options.count("component-db") )
+    {
+        components.open( options["component-db"] );   // a missing store starts empty
+        components.saving = true;
+    }
+
+    Profiler& profiler = Profiler::shared();
+    if ( options.count("profile") )
+        profiler.enable();
+
+    Lookahead& lookahead = Lookahead::shared();
+    lookahead.enabled = options.count("lookahead") > 0;
+    if ( !options["lookahead"].empty() )
+        lookahead.candidates = atoi( options["lookahead"].c_str() );
+    if ( options.count("lookahead-threads") )
+        lookahead.threads = atoi( options["lookahead-threads"].c_str() );
+
+    Watchdog& watchdog = Watchdog::shared();
+    if ( options.count("move-timeout") || options.count("game-timeout") )
+        watchdog.start( atoi( options["move-timeout"].c_str() ), atoi( options["game-timeout"].c_str() ),
+                        options.count("timeout-grace") ? atoi( options["timeout-grace"].c_str() ) : WATCHDOG_GRACE_MS );
+
+    if ( options.count("replay") )
+    {
+        int repeat = options.count("replay-repeat") ? atoi( options["replay-repeat"].c_str() ) : 1;
+        if ( !replayTraces( options["replay"], repeat, cout ) )
+            cout << "[ERROR] Failed to read trace " << options["replay"] << "." << endl;
+        if ( profiler.enabled )
+            profiler.report( cout );
+        return 0;
+    }
+
+    if ( options.count("train-guess") )
+    {
+        string weights = options.count("guess-weights") ? options["guess-weights"] : "GuessWeights.hpp";
+        if ( !trainGuessModel( options["train-guess"], weights, cout ) )
+            cout << "[ERROR] Failed to train the guess model from " << options["train-guess"] << "." << endl;
+        return 0;
+    }
+
+    if ( options.count("stress") )
+    {
+        StressOptions stress;
+        if ( options.count("stress-size") && !parseBoardSize( options["stress-size"], stress.rows, stress.cols, stress.mines ) )
+            stress.rows = 0;
+        if ( options.count("stress-iterations") )
+            stress.iterations = atoi( options["stress-iterations"].c_str() );
+        if ( options.count("stress-keep") )
+            stress.keep = atoi( options["stress-keep"].c_str() );
+        stress.byTime = options["stress-metric"] == "time";
+        stress.seed = options.count("stress-seed") ? strtoul( options["stress-seed"].c_str(), nullptr, 10 ) : time( NULL );
+        if ( !searchStressWorlds( options["stress"], stress, cout ) )
+            cout << "[ERROR] Stress search failed; check --stress-size and the other --stress options." << endl;
+        if ( profiler.enabled )
+            profiler.report( cout );
+        return 0;
+    }
+
+    if ( options.count("lockstep") )
+    {
+        int rows, cols, mines;
+        string size = options.count("lockstep-size") ? options["lockstep-size"] : "beginner";
+        unsigned seed = options.count("lockstep-seed") ? strtoul( options["lockstep-seed"].c_str(), nullptr, 10 ) : time( NULL );
+        if ( !parseBoardSize( size, rows, cols, mines )
+             || !runLockstepBenchmark( rows, cols, mines, atoll( options["lockstep"].c_str() ), seed, cout ) )
+            cout << "[ERROR] Invalid --lockstep game count or --lockstep-size." << endl;
+        return 0;
+    }
+
+    if ( options.count("verify-replay") )
+    {
+        if ( !replayPositions( options["verify-replay"], cout ) )
+            cout << "[ERROR] Failed to read positions " << options["verify-replay"] << "." << endl;
+        return 0;
+    }
+
+    SolverVerifier& verifier = SolverVerifier::shared();
+    if ( options.count("verify") )
+    {
+        verifier.enabled = true;
+        if ( !verifier.open( options["verify"] ) )
+            cout << "[WARNING] Failed to open " << options["verify"] << "; mismatches won't be saved." << endl;
+    }
+
+    TraceWriter trace;
+    if ( options.count("trace") && !trace.open( options["trace"] ) )
+    {
+        cout << "[ERROR] Failed to open trace file " << options["trace"] << "." << endl;
+        return 0;
+    }
+
+    WorldOptions worldOptions;
+    worldOptions.cascade = options.count("cascade") > 0;
+    worldOptions.agentCommand = options["agent"];
+    worldOptions.watch = options.count("watch") > 0;
+    worldOptions.watchDelay = atoi( options["watch"].c_str() );
+    if ( options.count("trace") )
+        worldOptions.trace = &trace;
+
+    if ( options.count("agents") )
+    {
+        // the folder is the operand of -f
+        if ( argc < 3 || argv[1][0] != '-' || !strpbrk( argv[1], "fF" ) )
+        {
+            cout << "[ERROR] --agents needs -f FOLDER." << endl;
+            return 0;
+        }
+        compareAgents( argv[2], splitList( options["agents"] ), worldOptions, given, cout );
+        if ( profiler.enabled )
+            profiler.report( cout );
+        return 0;
+    }
+
+    if ( options.count("ab") )
+    {
+        vector<string> agents = splitList( options["ab"] );
+        ABOptions ab;
+        if ( options.count("ab-size") && !parseBoardSize( options["ab-size"], ab.rows, ab.cols, ab.mines ) )
+            ab.rows = 0;
+        if ( options.count("ab-games") )
+            ab.maxGames = atoi( options["ab-games"].c_str() );
+        if ( options.count("ab-check") )
+            ab.check = atoi( options["ab-check"].c_str() );
+        if ( options.count("ab-confidence") )
+            ab.confidence = atof( options["ab-confidence"].c_str() );
+        if ( options.count("ab-margin") )
+            ab.margin = atof( options["ab-margin"].c_str() );
+        ab.seed = options.count("ab-seed") ? strtoul( options["ab-seed"].c_str(), nullptr, 10 ) : time( NULL );
+        if ( agents.size() != 2 )
+            cout << "[ERROR] --ab needs two agents: --ab=A,B." << endl;
+        else if ( !runABTest( agents[0], agents[1], ab, worldOptions, given, cout ) )
+            cout << "[ERROR] A/B run failed; check --ab-size and the other --ab options." << endl;
+        if ( profiler.enabled )
+            profiler.report( cout );
+        return 0;
+    }
+
+    ResultsLog resultsLog;
+    ResultsLog* results = nullptr;
+    if ( options.count("results") )
+    {
+        if ( !resultsLog.open( options["results"], options.count("resume") > 0 ) )
+        {
+            cout << "[ERROR] Failed to open results log " << options["results"] << "." << endl;
+            return 0;
+        }
+        results = &resultsLog;
+    }
+    else if ( options.count("resume") )
+        cout << "[WARNING] --resume needs --results=FILE; running every world." << endl;
+
+    int status = runWorlds( argc, argv, worldOptions, results );
+
+    if ( profiler.enabled )
+        profiler.report( cout );
+
+    if ( verifier.enabled )
+        cout << "Verification: " << verifier.checks << " checks, " << verifier.mismatches << " mismatches, "
+             << verifier.skipped << " without a reference" << endl;
+
+    if ( lookahead.enabled )
+        cout << "Lookahead: " << lookahead.guesses << " guesses compared, " << lookahead.changed << " changed" << endl;
+
+    if ( watchdog.enabled )
+        cout << "Watchdog: " << watchdog.moveTimeouts << " move timeouts, " << watchdog.gameTimeouts << " game timeouts" << endl;
+
+    if ( options.count("component-db") )
+    {
+        cout << "Component cache: " << components.hits << " hits, " << components.misses << " misses" << endl;
+        if ( components.save( options["component-db"] ) )
+            cout << "Wrote " << min( components.size(), components.cap ) << " components to " << options["component-db"] << endl;
+        else
+            cout << "[ERROR] Failed to write component store." << endl;
+    }
+
+    if ( patterns.recording )
+    {
+        if ( patterns.save( options["gen-patterns"] ) )
+            cout << "Wrote " << patterns.size() << " patterns to " << options["gen-patterns"] << endl;
+        else
+            cout << "[ERROR] Failed to write pattern table." << endl;
+    }
+    return status;
+}
+
+int runWorlds( int argc, char *argv[], const WorldOptions& worldOptions, ResultsLog* results )
 {
 
     // Set random seed
     srand( time ( NULL ) );
 
     if ( argc == 1 ){
-        World world(false, std::string(), std::string());
+        World world(false, std::string(), std::string(), worldOptions);
         int score = world.run();
         if (score)
             cout << "WORLD COMPLETE" << endl;
@@ -124,7 +535,7 @@ int main( int argc, char *argv[] )
     {
         if ( folder )
             cout << "[WARNING] No folder specified; running on a random world." << endl;
-        World world(debug, aiType, std::string());
+        World world(debug, aiType, std::string(), worldOptions);
         int score = world.run();
         if (score)
             cout << "WORLD COMPLETE" << endl;
@@ -147,40 +558,87 @@ int main( int argc, char *argv[] )
 
         struct dirent *ent;
 
+        // One world (and agent) serves the whole folder; each file is
+        // loaded into it with reset() so buffers are reused between games
+        World* world = nullptr;
+
         double sumOfScores = 0;
         int easy = 0;
         int medium = 0;
         int expert = 0;
+        int failed = 0;
+        int timeouts = 0;
+
+        // if the watchdog has to end the run, the world being played is
+        // recorded as a timeout first, so --resume goes on after it; the
+        // log does that under its own lock (see ResultsLog.hpp)
+        Watchdog& watchdog = Watchdog::shared();
+        if ( results )
+            watchdog.forfeitHook = [results]( WatchdogTimeout ) {
+                results->abandon( "timeout" );
+            };
 
         while ((ent = readdir(dir)) != NULL)
         {
             if (ent->d_name[0] == '.')
                 continue;
-            if (verbose)
-                cout << "Running world: " << ent->d_name << endl;
-
-            string individualWorldFile = worldFile + "/" + ent->d_name;
-
-            int score;
-            try {
-                World world(debug, aiType, individualWorldFile);
-                score = world.run();
-                if (score == 3)
-                    ++expert;
-                else if (score == 2)
-                    ++medium;
-                else if (score == 1)
-                    ++easy;
-            }
-            catch (...) {
-                sumOfScores = 0;
-                break;
+
+            // a world played by an earlier run counts without playing it again
+            const WorldResult* recorded = results ? results->find( ent->d_name ) : nullptr;
+            WorldResult result;
+            if ( recorded )
+                result = *recorded;
+            else
+            {
+                if (verbose)
+                    cout << "Running world: " << ent->d_name << endl;
+
+                string individualWorldFile = worldFile + "/" + ent->d_name;
+                result.world = ent->d_name;
+                if ( results )
+                    results->begin( result.world );
+
+                auto start = chrono::steady_clock::now();
+                try {
+                    if ( world )
+                        world->reset(individualWorldFile);
+                    else
+                        world = new World(debug, aiType, individualWorldFile, worldOptions);
+                    result.score = world->run();
+                    result.outcome = watchdog.timedOut() ? "timeout" : result.score ? "win" : "loss";
+                    result.moves = world->moves();
+                    result.peakFrontier = world->peakFrontier();
+                }
+                catch (...) {
+                    // one bad world costs its own score, not the run's;
+                    // the next world starts from a fresh World
+                    cout << "[ERROR] Failed to run world " << ent->d_name << "." << endl;
+                    result.score = 0;
+                    result.outcome = "error";
+                    delete world;
+                    world = nullptr;
+                }
+                result.ms = chrono::duration<double, milli>( chrono::steady_clock::now() - start ).count();
+                if ( results )
+                    results->finish( result );
             }
 
-            sumOfScores += score;
+            if (result.score == 3)
+                ++expert;
+            else if (result.score == 2)
+                ++medium;
+            else if (result.score == 1)
+                ++easy;
+            if (result.outcome == "error" || result.outcome == "crash")
+                ++failed;
+            if (result.outcome == "timeout")
+                ++timeouts;
+            sumOfScores += result.score;
         }
 
         closedir(dir);
+        delete world;
+        watchdog.forfeitHook = nullptr;
 
 
         if ( outputFile == "" )
@@ -190,6 +648,10 @@ int main( int argc, char *argv[] )
             cout << "medium: "  << medium << endl;
             cout << "expert: " << expert << endl;
             cout << "score: " << sumOfScores << endl;
+            if (failed)
+                cout << "failed: " << failed << endl;
+            if (timeouts)
+                cout << "timeouts: " << timeouts << endl;
         }
         else
         {
@@ -199,6 +661,10 @@ int main( int argc, char *argv[] )
             file << "medium: " << medium << endl;
             file << "expert: " << expert << endl;
             file << "score: " << sumOfScores << endl;
+            if (failed)
+                file << "failed: " << failed << endl;
+            if (timeouts)
+                file << "timeouts: " << timeouts << endl;
             file.close();
         }
         return 0;
@@ -210,7 +676,7 @@ int main( int argc, char *argv[] )
         if ( verbose )
             cout << "Running world: " << worldFile << endl;
 
-        World world(debug, aiType, worldFile);
+        World world(debug, aiType, worldFile, worldOptions);
         int score = world.run();
         if ( outputFile == "" )
         {
@@ -19,140 +19,59 @@
 
 #include "MyAI.hpp"
 
-string Coord::toString() const {
-        return "(" + std::to_string(x+1) + ", " + std::to_string(y+1) + ")";
-}
-
-int interleave_bits(int x, int y) {
-    int z = 0;
-    for (int i = 0; i < sizeof(int) * 4; ++i) {
-        z |= (x & (1 << i)) << i | (y & (1 << i)) << (i + 1);
-    }
-    return z;
-}
-
-bool Coord::operator<(const Coord& other) const {
-        return interleave_bits(x, y) < interleave_bits(other.x, other.y);
-}
-
-// constructor for BoardRep
-BoardRep::BoardRep(int _rowDimension, int _colDimension, int _totalMines)
-    :rowSize(_rowDimension), colSize(_colDimension), totalMines(_totalMines)
-{   
-    board = new Square*[rowSize];
-    for (int i = 0; i < rowSize; ++i) {
-        board[i] = new Square[colSize];
-        for (int j = 0; j < colSize; ++j) {
-            board[i][j] = COVERED;
-            all_covered.emplace(i, j);
-        }
-    }
-    covered_sq_count = rowSize * colSize;
-}
-
-// destructor for BoardRep
-BoardRep::~BoardRep()
-{
-        for (int i = 0; i < rowSize; ++i) {
-            delete[] board[i];
-        }
-        delete[] board;
-}
-
-// Returns True if the coordinate is uncovered
-bool BoardRep::isUncovered(Coord co) 
-{
-    return getSquare(co.x, co.y) >= 0;
-}
-
-// Returns True if both are covered or both are uncovered. Bounds checking is applied to b
-bool BoardRep::matchingStatus(Coord a, Coord b)
-{
-    return isUncovered(a) == isUncovered(b);
-}
-
-// Returns a list of all adjacent Coordinates of opposite status
-list<Coord> BoardRep::listOppositeNeighbors(Coord coord)
-{
-    list<Coord> opposite_neighbors;
-    Coord neighbor {0, 0};
-    for(int i = coord.x-1; i <= coord.x+1; ++i) {
-        for(int j = coord.y-1; j <= coord.y+1; ++j) {
-            neighbor = Coord{i, j};
-            if ((i != coord.x || j != coord.y) &&
-                withinBounds(i, j) &&
-                !matchingStatus(coord, neighbor))
-            {
-                opposite_neighbors.push_back(neighbor);
-            }
-        }
-    }
-    return opposite_neighbors;
-}
-
-// Returns a list of all adjacent Coordinates of opposite status
-list<Coord> BoardRep::listMatchingNeighbors(Coord coord)
-{
-    list<Coord> matching_neighbors;
-    Coord neighbor {0, 0};
-    for(int i = coord.x-1; i <= coord.x+1; ++i) {
-        for(int j = coord.y-1; j <= coord.y+1; ++j) {
-            neighbor = Coord{i, j};
-            if ((i != coord.x || j != coord.y) &&
-                withinBounds(i, j) &&
-                matchingStatus(coord, neighbor))
-            {
-                matching_neighbors.push_back(neighbor);
-            }
-        }
-    }
-    return matching_neighbors;
-}
-
-// Returns true only if provided row and col are within bounds.
-bool BoardRep::withinBounds(int col, int row)
-{
-    
-    return (row >= 0) && (row < rowSize) && (col >= 0) && (col < colSize);
-}
-
-// Marks the square at (row, col) as uncovered and stores its value. Returns false if square out of bounds
-bool BoardRep::updateSquare(int col, int row, Square value)
+// Start of myAI class, which contains core functionality
+MyAI::MyAI (int _rowDimension, int _colDimension, int _totalMines, int _agentX, int _agentY) : Agent()
 {
-    if (!withinBounds(col, row)) {
-        return false;
-    } 
-    // checks to make sure board had a covered square and then is getting uncovered
-    else if (board[row][col] == COVERED && value >= 0) {
-        covered_sq_count -= 1;
-        all_covered.erase(Coord(col, row)); 
-    }
-    board[row][col] = value;
-    return true;
-}
+    start_time = std::chrono::steady_clock::now();
+    boardObj = new BoardRep(_rowDimension, _colDimension, _totalMines);
+    agentCoord = Coord(_agentX, _agentY);
+    batch_uncovered.assign(1, agentCoord);
+    size_buffers();
+    all_possible_mappings.reserve(MAPPING_RESERVE);
+};
 
-// Returns a pointer to the square at (row, col), returning nullptr if out of bounds
-Square BoardRep::getSquare(int col, int row) 
+// Sizes the queues and scratch buffers for the current board. Large boards
+// get sparse ones so memory follows the frontier rather than the board.
+void MyAI::size_buffers()
 {
-    if (!withinBounds(col, row)) {
-        return INVALID;
+    int rows = boardObj->rowSize;
+    int cols = boardObj->colSize;
+    bool sparse = boardObj->large;
+    toUncoverVector.setup(rows, cols, sparse);
+    toProcessVector.setup(rows, cols, sparse);
+    regions.setup(rows, cols, sparse);
+    pattern_centers.setup(rows, cols, sparse);
+    if (!sparse) {
+        frontier_enumerate.reserve(rows * cols);
+        consistent_mapping.reserve(rows * cols);
     }
-    return board[row][col];
-}
-
-// returns true if isDone
-bool BoardRep::isDone()
-{
-    return covered_sq_count <= totalMines;
 }
 
-// Start of myAI class, which contains core functionality
-MyAI::MyAI (int _rowDimension, int _colDimension, int _totalMines, int _agentX, int _agentY) : Agent()
+// Prepares this agent for a new game, keeping its buffers if the board
+// dimensions are unchanged
+void MyAI::reset(int _rowDimension, int _colDimension, int _totalMines, int _agentX, int _agentY)
 {
+    bool resized = _rowDimension != boardObj->rowSize || _colDimension != boardObj->colSize;
     start_time = std::chrono::steady_clock::now();
-    boardObj = new BoardRep(_rowDimension, _colDimension, _totalMines);
+    boardObj->reset(_rowDimension, _colDimension, _totalMines);
     agentCoord = Coord(_agentX, _agentY);
-};
+    batch_uncovered.assign(1, agentCoord);
+    if (resized) {
+        size_buffers();
+    } else {
+        toUncoverVector.clear();
+        toProcessVector.clear();
+    }
+    all_possible_mappings.clear();
+    max_time_taken = 0;
+    peak_frontier = 0;
+    search_nodes = 0;
+    justPerformedEnumeration = false;
+    component_guess_valid = false;
+    lowest_risk_is_current = false;
+    total_lowest_risk_coord = Coord(0, 0);
+    total_lowest_risk = 0;
+}
 
 int MyAI::secondsLeft() {
     auto current_time = std::chrono::steady_clock::now();
@@ -164,7 +83,7 @@ MyAI::~MyAI() {
     delete boardObj;
 }
 
-void printCoordSet(std::set<Coord> s) {
+void printCoordSet(const CoordSet& s) {
     cout << "{ ";
     for (auto elem : s) {
         cout << "(" << elem.x + 1 << ", " << elem.y + 1 << "), ";
@@ -174,13 +93,72 @@ void printCoordSet(std::set<Coord> s) {
 
 Agent::Action MyAI::getAction(int number)
 {   
+    ProfileScope profile(PROFILE_AGENT);
     //1: Process Uncovered Coord
     process_uncovered_coord(agentCoord, number);
 
+    return next_action();
+}
+
+// Batch form of getAction. percepts answers the previous batch, one per
+// action World applied. After the first action, every other square already
+// known to be safe is added to the batch, so a run of deductions costs one
+// call instead of one per square.
+void MyAI::getActions(const vector<int>& percepts, vector<Action>& actions)
+{
+    ProfileScope profile(PROFILE_AGENT);
+    for (size_t i = 0; i < percepts.size() && i < batch_uncovered.size(); ++i) {
+        process_uncovered_coord(batch_uncovered[i], percepts[i]);
+    }
+    batch_uncovered.clear();
+
+    Action first = next_action();
+    actions.push_back(first);
+    if (first.action != UNCOVER) {
+        return;
+    }
+    batch_uncovered.push_back(agentCoord);
+
+    while (!toUncoverVector.empty()) {
+        Coord c = toUncoverVector.back();
+        toUncoverVector.pop_back();
+        if (boardObj->getSquare(c.x, c.y) == COVERED) {
+            actions.push_back({UNCOVER, c.x, c.y});
+            batch_uncovered.push_back(c);
+        }
+    }
+    agentCoord = batch_uncovered.back();
+}
+
+// Squares World uncovered by a cascade. All of them are written to the
+// board before any is processed, so the frontier only ever sees the
+// squares that are still covered after the whole region opened.
+void MyAI::revealed(const vector<Reveal>& squares)
+{
+    for (const Reveal& r : squares) {
+        boardObj->updateSquare(r.x, r.y, r.number);
+    }
+    for (const Reveal& r : squares) {
+        Coord c(r.x, r.y);
+        process_uncovered_coord(c, r.number);
+    }
+}
+
+// The agent's decision procedure: picks the next action from the current
+// board without consuming a percept
+Agent::Action MyAI::next_action()
+{
+    // every endgame solve of this move shares one expectimax budget
+    endgame.newMove();
+
     //2: Check if Board is Complete
     if (boardObj->isDone()) {
         return {LEAVE,-1,-1};
     }
+    // the watchdog stopped this game; give the turn back at once
+    if (Watchdog::cancelled()) {
+        return {LEAVE, -1, -1};
+    }
 
     while(!toUncoverVector.empty() || !toProcessVector.empty() || !justPerformedEnumeration) 
     {
@@ -210,17 +188,57 @@ Agent::Action MyAI::getAction(int number)
         //4: Enumerate Frontier Checking Strategy 
         else if (!justPerformedEnumeration)
         {
-            if(boardObj->frontier_covered.size()) {
+            peak_frontier = max<int>(peak_frontier, boardObj->frontier_covered.size());
+            if (SolverVerifier::shared().enabled) {
+                SolverVerifier::shared().reference(*boardObj);
+            }
+            // known local patterns are a table lookup away; try them first
+            if (patternStrategy()) {
+                verify_engine("pattern", false);
+                continue;
+            }
+            // then components small enough to solve (or recall) on their own
+            if (!boardObj->large && componentStrategy()) {
+                verify_engine("component", false);
+                continue;
+            }
+            // with few squares left, the rest of the game is solved exactly
+            if (!boardObj->large && endgameStrategy()) {
+                continue;
+            }
+            if (boardObj->large) {
+                // large boards solve each frontier region on its own
+                if (boardObj->frontier_covered.size()) {
+                    enumerateFrontierRegions();
+                    verify_engine("regions", false);
+                }
+            }
+            else if(boardObj->frontier_covered.size()) {
                 int time = secondsLeft();
-                if (time < 2 && boardObj->frontier_covered.size() > 30) {
+                // past what enumeration finishes, the components just
+                // solved already give the safest square
+                if (boardObj->frontier_covered.size() > SLOPPY_MAX_FACTORS && component_guess_valid) {
+                    Coord guess = component_guess;
+                    lookahead_guess(guess);
+                    toUncoverVector.push_back(guess);
+                }
+                else if (time < 2 && boardObj->frontier_covered.size() > 30) {
+                    // no time left to enumerate; the guess model picks the guess
+                    Coord guess;
+                    if (guessSquare(*boardObj, mine_density(), guess)) {
+                        toUncoverVector.push_back(guess);
+                    }
                     justPerformedEnumeration = true;
                     continue;
                 }
                 else if (time < 60 + (max_time_taken * 1.5)) {
+                    bool complete = boardObj->frontier_covered.size() <= SLOPPY_MAX_FACTORS;
                     enumerateFrontierStrategy_Sloppy();
+                    verify_engine("sloppy", complete);
                 }
                 else {
                     enumerateFrontierStrategy();
+                    verify_engine("exact", true);
                     int used = time - secondsLeft();
                     if (used > max_time_taken) {
                         max_time_taken = used;
@@ -234,17 +252,23 @@ Agent::Action MyAI::getAction(int number)
 
     //5: Best Probability Strategy
     if (boardObj->frontier_covered.size()) {
-        Coord c = *boardObj->frontier_covered.begin();
+        Coord c = boardObj->frontier_covered.first();
         agentCoord = c;
         return {UNCOVER, c.x, c.y};
     }
 
     if (boardObj->all_covered.size()) {
-        Coord c = *boardObj->all_covered.begin();
+        Coord c = boardObj->all_covered.first();
         agentCoord = c;
         return {UNCOVER, c.x, c.y};
     }
 
+    Coord unexplored;
+    if (boardObj->large && boardObj->findUnexplored(unexplored)) {
+        agentCoord = unexplored;
+        return {UNCOVER, unexplored.x, unexplored.y};
+    }
+
     // TODO STRATEGIES
     // - smart probability with frontier
     // - time strategy, look at documentation
@@ -258,11 +282,25 @@ Agent::Action MyAI::getAction(int number)
     return {LEAVE, -1, -1}; // temporarily as not implemented best prob strategy
 }
 
-void MyAI::enumerateFrontierStrategy() {
-    vector<pair<Coord, gameTile>> covered_frontier_enumerate;
+// Loads up to max_size covered frontier coords into frontier_enumerate, in
+// Coord order so that neighboring squares are enumerated close together
+void MyAI::fill_frontier_enumerate(size_t max_size) {
+    frontier_enumerate.clear();
     for (const auto& coord : boardObj->frontier_covered) {
-        covered_frontier_enumerate.emplace_back(coord, NONE);
+        frontier_enumerate.emplace_back(coord, NONE);
     }
+    sort(frontier_enumerate.begin(), frontier_enumerate.end(),
+        [](const pair<Coord, gameTile>& a, const pair<Coord, gameTile>& b) { return a.first < b.first; });
+    if (frontier_enumerate.size() > max_size) {
+        frontier_enumerate.resize(max_size);
+    }
+    all_possible_mappings.clear();
+}
+
+void MyAI::enumerateFrontierStrategy() {
+    ProfileScope profile(PROFILE_EXACT);
+    fill_frontier_enumerate(boardObj->frontier_covered.size());
+    vector<pair<Coord, gameTile>>& covered_frontier_enumerate = frontier_enumerate;
     for(const auto& p : covered_frontier_enumerate)
         boardObj->updateSquare(p.first.x, p.first.y, UNDEFINED);
 
@@ -274,22 +312,56 @@ void MyAI::enumerateFrontierStrategy() {
 
     // the stat enumeration backup step:
     if (toUncoverVector.empty() && lowest_risk_is_current) {
-        toUncoverVector.push_back(total_lowest_risk_coord);
+        Coord guess = total_lowest_risk_coord;
+        lookahead_guess(guess);
+        toUncoverVector.push_back(guess);
     }
     lowest_risk_is_current = false;
 }
 
-void MyAI::enumerateFrontierStrategy_Sloppy() {
-    int MAX_FACTORS = 39;
-    vector<pair<Coord, gameTile>> covered_frontier_enumerate;
-    int i = 0;
-    for (const auto& coord : boardObj->frontier_covered) {
-        covered_frontier_enumerate.emplace_back(coord, NONE);
-        ++i;
-        if (i > MAX_FACTORS) {
-            break;
+// Large-board enumeration: solves every frontier component (capped at
+// LARGE_MAX_COMPONENT squares) separately, queueing the squares that are
+// safe or mines in every solution. Without any, the square least likely to
+// be a mine is queued instead.
+void MyAI::enumerateFrontierRegions() {
+    ProfileScope profile(PROFILE_REGIONS);
+    regions.split(*boardObj, LARGE_MAX_COMPONENT);
+
+    bool found = false;
+    double lowest_risk = 2;
+    Coord lowest_risk_coord;
+    for (const FrontierComponent& comp : regions.components) {
+        if (!solve_cached(comp, region_solution)) {
+            continue;
         }
+        for (size_t i = 0; i < comp.cells.size(); ++i) {
+            const Coord& c = comp.cells[i];
+            double mines = region_solution.mine_counts[i];
+            if (mines == 0) {
+                toUncoverVector.push_back(c);
+                found = true;
+            } else if (mines == region_solution.total) {
+                flag_square(c);
+                found = true;
+            } else if (mines / region_solution.total < lowest_risk) {
+                lowest_risk = mines / region_solution.total;
+                lowest_risk_coord = c;
+            }
+        }
+    }
+
+    if (!found && lowest_risk <= 1) {
+        lookahead_guess(lowest_risk_coord);
+        toUncoverVector.push_back(lowest_risk_coord);
     }
+}
+
+void MyAI::enumerateFrontierStrategy_Sloppy() {
+    ProfileScope profile(PROFILE_SLOPPY);
+    int MAX_FACTORS = SLOPPY_MAX_FACTORS;
+    int i = min<int>(boardObj->frontier_covered.size(), MAX_FACTORS + 1);
+    fill_frontier_enumerate(i);
+    vector<pair<Coord, gameTile>>& covered_frontier_enumerate = frontier_enumerate;
     for(const auto& p : covered_frontier_enumerate)
         boardObj->updateSquare(p.first.x, p.first.y, UNDEFINED);
     
@@ -307,12 +379,18 @@ void MyAI::enumerateFrontierStrategy_Sloppy() {
 
     // the stat enumeration backup step:
     if (toUncoverVector.empty() && lowest_risk_is_current) {
-        toUncoverVector.push_back(total_lowest_risk_coord);
+        Coord guess = total_lowest_risk_coord;
+        lookahead_guess(guess);
+        toUncoverVector.push_back(guess);
     }
     lowest_risk_is_current = false;
 }
 
 void MyAI::process_recursive_mappings(vector<pair<Coord, gameTile>>& vector_to_enumerate, int index, gameTile value) {
+    if (Watchdog::cancelled()) {
+        return;
+    }
+    ++search_nodes;
     Coord& c = vector_to_enumerate[index].first;
 
     vector_to_enumerate[index].second = value;
@@ -323,7 +401,8 @@ void MyAI::process_recursive_mappings(vector<pair<Coord, gameTile>>& vector_to_e
     
     if (check_constraints(c)) {
         if (index == vector_to_enumerate.size() - 1) {
-            all_possible_mappings.push_back(vector_to_enumerate);
+            for (const auto& p : vector_to_enumerate)
+                all_possible_mappings.push_back(p.second);
         } else {
             process_recursive_mappings(vector_to_enumerate, index+1, BOMB);
             process_recursive_mappings(vector_to_enumerate, index+1, SAFE);
@@ -334,7 +413,7 @@ void MyAI::process_recursive_mappings(vector<pair<Coord, gameTile>>& vector_to_e
 }
 
 bool MyAI::check_constraints(Coord& c) {
-    vector<Coord> neighbors;
+    NeighborBuf neighbors;
     int flagged_neighbors;
     int undefined_neighbors;
     int square_num;
@@ -353,7 +432,8 @@ bool MyAI::check_constraints(Coord& c) {
 }
 
 void MyAI::add_consistent_mappings() {
-    vector<pair<Coord, gameTile>> cmap;
+    vector<pair<Coord, gameTile>>& cmap = consistent_mapping;
+    cmap.clear();
 
     // TODO weird but all_possible_mappings gets deleted after priting, else it doesn't
     // TODO combining consistent mappings doesn't seem to work
@@ -364,29 +444,31 @@ void MyAI::add_consistent_mappings() {
     int lowest_risk = 99999;
 
     // populate cmap    
-    if(all_possible_mappings.size() == 0) {
+    const size_t num_mappings = mapping_count();
+    if(num_mappings == 0) {
         return;
-    } else if (all_possible_mappings.size() == 1){
-        cmap = all_possible_mappings[0];
+    } else if (num_mappings == 1){
+        for(size_t i=0; i < frontier_enumerate.size(); ++i)
+            cmap.emplace_back(frontier_enumerate[i].first, mapping(0, i));
     } else {
-        const vector<pair<Coord, gameTile>>& first_map = all_possible_mappings[0];
-        for(int i=0; i < first_map.size(); ++i)
+        for(size_t i=0; i < frontier_enumerate.size(); ++i)
         {
             bool all_equal = true;
-            int this_risk = (first_map[i].second == BOMB ? 1 : 0); // This risk starts at 1 if the first enumeration is a bomb
-            for(int j=1; j < all_possible_mappings.size(); ++j) {
-                if (first_map[i].second != all_possible_mappings[j][i].second) {
+            const gameTile first_value = mapping(0, i);
+            int this_risk = (first_value == BOMB ? 1 : 0); // This risk starts at 1 if the first enumeration is a bomb
+            for(size_t j=1; j < num_mappings; ++j) {
+                if (first_value != mapping(j, i)) {
                     all_equal = false;
                     // Added condition to not break if no safe move has been found yet or if this move
                     // might be safer than the current safest (therefore, we still need to count ALL of the ways this one could be a bomb)
                     if (found_safe_move || (this_risk >= lowest_risk)) {
                         break;
                     }
-                    if (all_possible_mappings[j][i].second == BOMB) ++this_risk; //
+                    if (mapping(j, i) == BOMB) ++this_risk; //
                 }
             }
             if (all_equal) {
-                cmap.push_back(first_map[i]);
+                cmap.emplace_back(frontier_enumerate[i].first, first_value);
                 // Added to skip further stat enumeration computation upon finding a safe move:
                 if (!this_risk) {
                     found_safe_move = true;
@@ -395,7 +477,7 @@ void MyAI::add_consistent_mappings() {
             if (found_safe_move) break;
             if (this_risk < lowest_risk) { // Remembers this coord if it has the lowest risk so far
                lowest_risk = this_risk;
-               lowest_risk_coord = first_map[i].first;
+               lowest_risk_coord = frontier_enumerate[i].first;
             } //
         }
     }
@@ -422,7 +504,8 @@ void MyAI::add_consistent_mappings() {
 }
 
 void MyAI::add_ONE_consistent_mapping() {
-    vector<pair<Coord, gameTile>> cmap;
+    vector<pair<Coord, gameTile>>& cmap = consistent_mapping;
+    cmap.clear();
 
     // TODO weird but all_possible_mappings gets deleted after priting, else it doesn't
     // TODO combining consistent mappings doesn't seem to work
@@ -433,29 +516,31 @@ void MyAI::add_ONE_consistent_mapping() {
     int lowest_risk = 99999;
 
     // populate cmap    
-    if(all_possible_mappings.size() == 0) {
+    const size_t num_mappings = mapping_count();
+    if(num_mappings == 0) {
         return;
-    } else if (all_possible_mappings.size() == 1){
-        cmap = all_possible_mappings[0];
+    } else if (num_mappings == 1){
+        for(size_t i=0; i < frontier_enumerate.size(); ++i)
+            cmap.emplace_back(frontier_enumerate[i].first, mapping(0, i));
     } else {
-        const vector<pair<Coord, gameTile>>& first_map = all_possible_mappings[0];
-        for(int i=0; i < first_map.size(); ++i)
+        for(size_t i=0; i < frontier_enumerate.size(); ++i)
         {
             bool all_equal = true;
-            int this_risk = (first_map[i].second == BOMB ? 1 : 0); // This risk starts at 1 if the first enumeration is a bomb
-            for(int j=1; j < all_possible_mappings.size(); ++j) {
-                if (first_map[i].second != all_possible_mappings[j][i].second) {
+            const gameTile first_value = mapping(0, i);
+            int this_risk = (first_value == BOMB ? 1 : 0); // This risk starts at 1 if the first enumeration is a bomb
+            for(size_t j=1; j < num_mappings; ++j) {
+                if (first_value != mapping(j, i)) {
                     all_equal = false;
                     // Added condition to not break if no safe move has been found yet or if this move
                     // might be safer than the current safest (therefore, we still need to count ALL of the ways this one could be a bomb)
                     if (found_safe_move || (this_risk >= lowest_risk)) {
                         break;
                     }
-                    if (all_possible_mappings[j][i].second == BOMB) ++this_risk; //
+                    if (mapping(j, i) == BOMB) ++this_risk; //
                 }
             }
             if (all_equal) {
-                cmap.push_back(first_map[i]);
+                cmap.emplace_back(frontier_enumerate[i].first, first_value);
                 // Added to skip further stat enumeration computation upon finding a safe move:
                 if (!this_risk) {
                     found_safe_move = true;
@@ -464,7 +549,7 @@ void MyAI::add_ONE_consistent_mapping() {
             if (found_safe_move) break;
             if (this_risk < lowest_risk) { // Remembers this coord if it has the lowest risk so far
                lowest_risk = this_risk;
-               lowest_risk_coord = first_map[i].first;
+               lowest_risk_coord = frontier_enumerate[i].first;
             } //
         }
     }
@@ -497,11 +582,8 @@ void MyAI::process_uncovered_coord(Coord& coord, int number) {
 
     // Changes 5/18: Updating the covered and uncovered frontiers
     boardObj->frontier_covered.erase(coord); // 1. Remove the uncovered coord from the covered frontier, if it exists
-    vector<Coord> opposite_neighbors;
-    get_neighbors(coord, COVERED, opposite_neighbors);
-    //list<Coord> opposite_neighbors = boardObj->listOppositeNeighbors(coord); // 2. Find the covered neighbors of coord
-    list<Coord> matching_neighbors = boardObj->listMatchingNeighbors(coord); // 2.5 Find the uncovered neighbors of coord
-    list<Coord> coord2;
+    NeighborBuf opposite_neighbors;
+    get_neighbors(coord, COVERED, opposite_neighbors); // 2. Find the covered neighbors of coord
     if (opposite_neighbors.size()) { // 3. If the uncovered coord has covered neighbors, then it now belongs in the uncovered frontier
         // boardObj->frontier_uncovered.insert(coord);
         for (Coord covered_adj: opposite_neighbors) { // 4. Enter all the covered neighbors into the covered frontier
@@ -518,6 +600,187 @@ void MyAI::process_uncovered_coord(Coord& coord, int number) {
     }
 }
 
+// Looks up the pattern window around every numbered square that borders the
+// covered frontier and acts on the forced squares. Returns true if any
+// square was queued or flagged.
+bool MyAI::patternStrategy() {
+    ProfileScope profile(PROFILE_PATTERN);
+    PatternTable& table = PatternTable::shared();
+    if (table.empty() && !table.recording) {
+        return false;
+    }
+
+    pattern_centers.clear();
+    for (const Coord& c : boardObj->frontier_covered) {
+        NeighborBuf numbered;
+        get_neighbors(c, NUMBERED, numbered);
+        for (const Coord& n : numbered) {
+            pattern_centers.insert(n);
+        }
+    }
+
+    bool found = false;
+    for (const Coord& center : pattern_centers) {
+        PatternBuf safe, mines;
+        if (!table.lookup(*boardObj, center, safe, mines)) {
+            continue;
+        }
+        for (const Coord& c : safe) {
+            if (boardObj->getSquare(c.x, c.y) == COVERED) {
+                toUncoverVector.push_back(c);
+                found = true;
+            }
+        }
+        for (const Coord& c : mines) {
+            if (boardObj->getSquare(c.x, c.y) == COVERED) {
+                flag_square(c);
+                found = true;
+            }
+        }
+    }
+    return found;
+}
+
+// Solves every frontier component on its own, by backtracking up to
+// COMPONENT_SOLVE_LIMIT squares and by the sweep beyond, and acts on the
+// squares that are safe or mines in all of its solutions. Returns true if
+// any were found. Otherwise, if every component was solved, the safest
+// square is kept in component_guess for step 4.
+bool MyAI::componentStrategy() {
+    ProfileScope profile(PROFILE_COMPONENT);
+    regions.split(*boardObj, boardObj->frontier_covered.size());
+    verify_solvers();
+
+    bool found = false;
+    double lowest_risk = 2;
+    component_guess_valid = true;
+    for (const FrontierComponent& comp : regions.components) {
+        bool solved;
+        if (comp.cells.size() > COMPONENT_SOLVE_LIMIT) {
+            ProfileScope sweep(PROFILE_SWEEP);
+            solved = sweepComponent(comp, region_solution) && region_solution.total > 0;
+        } else {
+            solved = solve_cached(comp, region_solution);
+        }
+        if (!solved) {
+            component_guess_valid = false;
+            continue;
+        }
+        for (size_t i = 0; i < comp.cells.size(); ++i) {
+            double mines = region_solution.mine_counts[i];
+            if (mines == 0) {
+                toUncoverVector.push_back(comp.cells[i]);
+                found = true;
+            } else if (mines == region_solution.total) {
+                flag_square(comp.cells[i]);
+                found = true;
+            } else if (mines / region_solution.total < lowest_risk) {
+                lowest_risk = mines / region_solution.total;
+                component_guess = comp.cells[i];
+            }
+        }
+    }
+    component_guess_valid = component_guess_valid && !found && lowest_risk <= 1;
+    return found;
+}
+
+// Solves the whole board, counting the mines left, once at most
+// ENDGAME_MAX_SQUARES squares are unknown. Queues the forced squares, or
+// the best guess when there are none. Returns false if the board is too
+// big or took too long, leaving the decision to the enumeration.
+bool MyAI::endgameStrategy() {
+    ProfileScope profile(PROFILE_ENDGAME);
+    if (boardObj->all_covered.size() > ENDGAME_MAX_SQUARES) {
+        return false;
+    }
+    int flagged = boardObj->covered_sq_count - boardObj->all_covered.size();
+    if (!endgame.solve(*boardObj, boardObj->totalMines - flagged)) {
+        return false;
+    }
+    for (const Coord& c : endgame.safe) {
+        toUncoverVector.push_back(c);
+    }
+    for (const Coord& c : endgame.mines) {
+        flag_square(c);
+    }
+    if (endgame.safe.empty() && endgame.mines.empty()) {
+        toUncoverVector.push_back(endgame.guess);
+    }
+    return true;
+}
+
+// Solves a component through the component cache, storing the result on a
+// miss. Small components skip the cache; solving them is cheaper.
+bool MyAI::solve_cached(const FrontierComponent& comp, ComponentSolution& solution) {
+    if (comp.cells.size() < COMPONENT_CACHE_MIN_CELLS) {
+        return solveComponent(comp, solution);
+    }
+    ComponentCache& cache = ComponentCache::shared();
+    cache.canonicalize(comp, component_key);
+    if (cache.lookup(component_key, solution)) {
+        return solution.total > 0;
+    }
+    solveComponent(comp, solution);
+    cache.store(component_key, solution);
+    return solution.total > 0;
+}
+
+// Lets the lookahead replace a guess with a square about as safe whose
+// number is likely to reveal more, when the lookahead is on and time allows
+void MyAI::lookahead_guess(Coord& guess) {
+    Lookahead& lookahead = Lookahead::shared();
+    if (!lookahead.enabled || secondsLeft() < 2) {
+        return;
+    }
+    regions.split(*boardObj, boardObj->large ? LARGE_MAX_COMPONENT : boardObj->frontier_covered.size());
+    lookahead_solutions.resize(regions.components.size());
+    for (size_t k = 0; k < regions.components.size(); ++k) {
+        const FrontierComponent& comp = regions.components[k];
+        if (comp.cells.size() > LOOKAHEAD_MAX_CELLS || !solve_cached(comp, lookahead_solutions[k])) {
+            lookahead_solutions[k].total = 0;
+        }
+    }
+
+    lookahead.choose(*boardObj, regions.components, lookahead_solutions, mine_density(), guess);
+}
+
+// The chance a square off the frontier is a mine
+double MyAI::mine_density() {
+    if (boardObj->large) {
+        return (double) boardObj->totalMines / (boardObj->rowSize * boardObj->colSize);
+    }
+    int unknown = boardObj->all_covered.size();
+    int flagged = boardObj->covered_sq_count - unknown;
+    return unknown ? (double) (boardObj->totalMines - flagged) / unknown : 0;
+}
+
+// Checks what an engine just did against the verifier's reference, when
+// verification is on
+void MyAI::verify_engine(const char* engine, bool complete) {
+    SolverVerifier& verifier = SolverVerifier::shared();
+    if (verifier.enabled) {
+        verifier.check(engine, complete, *boardObj, toUncoverVector);
+    }
+}
+
+// Checks the faster component engines against backtracking on the
+// components just split, when verification is on
+void MyAI::verify_solvers() {
+    SolverVerifier& verifier = SolverVerifier::shared();
+    if (verifier.enabled) {
+        verifier.checkSolver("sweep", *boardObj, regions.components);
+        verifier.checkSolver("bitslice", *boardObj, regions.components);
+    }
+}
+
+// Records a square known to be a mine and queues its numbered neighbors
+void MyAI::flag_square(const Coord& c) {
+    boardObj->updateSquare(c.x, c.y, FLAGGED);
+    boardObj->all_covered.erase(c);
+    boardObj->frontier_covered.erase(c);
+    add_neighbors(c, NUMBERED, toProcessVector);
+}
+
 void MyAI::singlePointProcess(Coord& nextCoord) {
     int covered_neighbors = count_neighbors(nextCoord, COVERED);
     int flagged_neighbors = count_neighbors(nextCoord, FLAGGED);
@@ -527,8 +790,9 @@ void MyAI::singlePointProcess(Coord& nextCoord) {
         add_neighbors(nextCoord, COVERED, toUncoverVector);
     }
     else if (covered_neighbors + flagged_neighbors == square_num) {
-        vector<Coord> updated_coords = update_neighbors(nextCoord, COVERED, FLAGGED);
-        for (Coord& c : updated_coords) {
+        NeighborBuf updated_coords;
+        update_neighbors(nextCoord, COVERED, FLAGGED, updated_coords);
+        for (const Coord& c : updated_coords) {
             add_neighbors(c, NUMBERED, toProcessVector);
             boardObj->frontier_covered.erase(c);
             boardObj->all_covered.erase(c);
@@ -536,7 +800,7 @@ void MyAI::singlePointProcess(Coord& nextCoord) {
     }
 }
 
-void MyAI::add_neighbors(const Coord& coord, Square type, vector<Coord>& list)
+void MyAI::add_neighbors(const Coord& coord, Square type, CoordQueue& list)
 {   
     for(int i = coord.x-1; i <= coord.x+1; ++i) {
         for(int j = coord.y-1; j <= coord.y+1; ++j) {
@@ -568,9 +832,8 @@ int MyAI::count_neighbors(const Coord& coord, Square type)
     return sum;
 }
 
-vector<Coord> MyAI::update_neighbors(Coord& coord, Square oldtype, Square newtype)
+void MyAI::update_neighbors(Coord& coord, Square oldtype, Square newtype, NeighborBuf& updated)
 {
-    vector<Coord> updated;
     for(int i = coord.x-1; i <= coord.x+1; ++i) {
         for(int j = coord.y-1; j <= coord.y+1; ++j) {
             if ((i != coord.x || j != coord.y) &&
@@ -582,10 +845,9 @@ vector<Coord> MyAI::update_neighbors(Coord& coord, Square oldtype, Square newtyp
             }
         }
     }
-    return updated;
 }
 
-void MyAI::get_neighbors(Coord& coord, Square type, vector<Coord>& vector)
+void MyAI::get_neighbors(const Coord& coord, Square type, NeighborBuf& vector)
 {
     for(int i = coord.x-1; i <= coord.x+1; ++i) {
         for(int j = coord.y-1; j <= coord.y+1; ++j) {
@@ -21,106 +21,130 @@
 #define MINE_SWEEPER_CPP_SHELL_MYAI_HPP
 
 #include "Agent.hpp"
+#include "BoardRep.hpp"
+#include "Frontier.hpp"
+#include "PatternTable.hpp"
+#include "ComponentCache.hpp"
+#include "Verifier.hpp"
+#include "Endgame.hpp"
+#include "Lookahead.hpp"
+#include "Sweep.hpp"
+#include "GuessModel.hpp"
+#include "Profiler.hpp"
+#include "Watchdog.hpp"
 #include <iostream>
 #include <vector>
 #include <map>
-#include <list> // TODO for an opt try to remove lists and only use vectors and queues
 #include <set>
 #include <algorithm>
 #include <unordered_set>
 #include <chrono>
 
-#define COVERED -1
-#define FLAGGED -2
-#define NUMBERED -3
-#define INVALID -4
-#define UNDEFINED -5
-typedef int Square;
-
-using namespace std;
-
-struct Coord {
-    int x;
-    int y;
-    Coord(int xCoord, int yCoord) : x(xCoord), y(yCoord) {}
-    string toString() const;
-    bool operator<(const Coord& other) const;
-    // Merge 5/24
-    bool operator==(const Coord& other) const {
-        return (x == other.x) && (y == other.y);
-    }
-};
+// Squares of enumerated mappings reserved up front (1 byte each); enough
+// for the exact enumeration of typical expert frontiers without regrowing
+#define MAPPING_RESERVE (1 << 22)
 
-// BoardRepresentation Class
-class BoardRep 
-{
-public:
-    // variables of BoardRep
-    const int rowSize;
-    const int colSize;
-    const int totalMines;
-    int covered_sq_count;
-    Square** board;
-
-    // Merge 5/24
-    set<Coord> frontier_covered;
-    set<Coord> frontier_uncovered;
-    set<Coord> all_covered;
-
-    // functions in BoardRep
-    BoardRep(int _rowDimension, int _colDimension, int _totalMines);
-    ~BoardRep();
-    bool updateSquare(int col, int row, Square value);
-    Square getSquare(int col, int row);
-    bool isDone();
-    bool withinBounds(int col, int row);
-
-    // Merge 5/24
-    bool isUncovered(Coord co); // Returns True if the coordinate is uncovered
-    bool matchingStatus(Coord a, Coord b); // Returns True if both are covered or both are uncovered
-    list<Coord> listOppositeNeighbors(Coord coord); // Returns a list to all of the coords with Squares of opposite status
-    list<Coord> listMatchingNeighbors(Coord coord); // Returns list: matching neighbors
-};
+// Largest frontier component solved in one piece on a large board
+#define LARGE_MAX_COMPONENT 32
 
-enum gameTile{
+// Largest component componentStrategy solves by backtracking; larger ones
+// are swept
+#define COMPONENT_SOLVE_LIMIT 30
+
+// Largest frontier the sloppy enumeration enumerates in full; beyond it,
+// only the first SLOPPY_MAX_FACTORS + 1 squares are enumerated
+#define SLOPPY_MAX_FACTORS 39
+
+enum gameTile : unsigned char {
     NONE,
     BOMB, 
     SAFE
 };
 
 // AI Class
-class MyAI : public Agent
+class MyAI final : public Agent
 {
 public:
     MyAI ( int _rowDimension, int _colDimension, int _totalMines, int _agentX, int _agentY );
     ~MyAI();
+    void reset ( int _rowDimension, int _colDimension, int _totalMines, int _agentX, int _agentY );
+    void size_buffers();
     Action getAction ( int number ) override;
+    bool supportsBatch () const override { return true; }
+    void getActions ( const vector<int>& percepts, vector<Action>& actions ) override;
+    bool supportsCascade () const override { return true; }
+    void revealed ( const vector<Reveal>& squares ) override;
+    int peakFrontier () const override { return peak_frontier; }
+    long long searchNodes () const override { return search_nodes; }
+    Action next_action();
 
     void process_uncovered_coord(Coord& coord, int number);
-    void add_neighbors(const Coord& coord, Square type, vector<Coord>& list);
+    void add_neighbors(const Coord& coord, Square type, CoordQueue& queue);
     int count_neighbors(const Coord& coord, Square type);
-    vector<Coord> update_neighbors(Coord& coord, Square oldtype, Square newtype);
+    void update_neighbors(Coord& coord, Square oldtype, Square newtype, NeighborBuf& updated);
 
     void singlePointProcess(Coord& nextCoord);
+    bool patternStrategy();
+    bool componentStrategy();
+    bool endgameStrategy();
+    bool solve_cached(const FrontierComponent& comp, ComponentSolution& solution);
+    void flag_square(const Coord& c);
+    void lookahead_guess(Coord& guess);
+    double mine_density();
+    void verify_engine(const char* engine, bool complete);
+    void verify_solvers();
     
     void enumerateFrontierStrategy();
+    void fill_frontier_enumerate(size_t max_size);
     void process_recursive_mappings(vector<pair<Coord, gameTile>>& coord_mapping, int index, gameTile value);
     void add_consistent_mappings();
     bool check_constraints(Coord& c);
-    void get_neighbors(Coord& coord, Square type, vector<Coord>& vector);
+    void get_neighbors(const Coord& coord, Square type, NeighborBuf& neighbors);
 
     void enumerateFrontierStrategy_Sloppy();
+    void enumerateFrontierRegions();
     void add_ONE_consistent_mapping();
     int secondsLeft();
 
     // Added 6/7
     std::chrono::steady_clock::time_point start_time;
     int max_time_taken = 0;
-
-    vector<vector<pair<Coord, gameTile>>> all_possible_mappings;
-    
-    vector<Coord> toUncoverVector;
-    vector<Coord> toProcessVector;
+    int peak_frontier = 0;      // largest frontier step 4 has seen this game
+    long long search_nodes = 0; // process_recursive_mappings calls this game
+
+    // Enumeration buffers, reused between calls. all_possible_mappings is
+    // flat: mapping m assigns all_possible_mappings[m * width + i] to
+    // frontier_enumerate[i].first.
+    vector<pair<Coord, gameTile>> frontier_enumerate;
+    vector<gameTile> all_possible_mappings;
+    vector<pair<Coord, gameTile>> consistent_mapping;
+    gameTile mapping(size_t m, size_t i) const { return all_possible_mappings[m * frontier_enumerate.size() + i]; }
+    size_t mapping_count() const { return frontier_enumerate.empty() ? 0 : all_possible_mappings.size() / frontier_enumerate.size(); }
+
+    CoordQueue toUncoverVector;
+    CoordQueue toProcessVector;
+
+    // Squares uncovered by the last batch, in the order of their percepts
+    vector<Coord> batch_uncovered;
+
+    // Numbered frontier squares whose windows patternStrategy looks up
+    CoordSet pattern_centers;
+
+    // Frontier component solving (all of it on large boards)
+    FrontierRegions regions;
+    ComponentSolution region_solution;
+    ComponentKey component_key;
+
+    // The safest frontier square over the components componentStrategy
+    // last solved, valid only if it solved all of them
+    bool component_guess_valid = false;
+    Coord component_guess = Coord(0, 0);
+
+    // Exact solving once few squares are left
+    EndgameSolver endgame;
+
+    // Solutions of regions.components for the guess lookahead
+    vector<ComponentSolution> lookahead_solutions;
     
     bool justPerformedEnumeration = false;
     BoardRep* boardObj;
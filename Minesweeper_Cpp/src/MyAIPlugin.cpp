@@ -0,0 +1,40 @@
+// ======================================================================
+// FILE:        MyAIPlugin.cpp
+//
+// DESCRIPTION: This file exports MyAI as an agent plugin ('make plugin'
+//              builds it into bin/MyAI.so). See AgentPlugin.hpp.
+//
+// NOTES:       - configure accepts the long options that change how MyAI
+//                plays, so a plugin runs with the same tables and
+//                features as the host's own MyAI. The component store is
+//                only read; the host is the one that writes it back.
+// ======================================================================
+
+#include "AgentPlugin.hpp"
+#include "MyAI.hpp"
+#include <cstdlib>
+
+MINESWEEPER_AGENT_PLUGIN(MyAI, "MyAI")
+
+AGENT_PLUGIN_EXPORT int minesweeper_agent_reset(Agent* agent, int rows, int cols, int mines, int startX, int startY)
+{
+    static_cast<MyAI*>(agent)->reset(rows, cols, mines, startX, startY);
+    return 1;
+}
+
+AGENT_PLUGIN_EXPORT void minesweeper_agent_configure(const char* name, const char* value)
+{
+    string option = name;
+    if (option == "patterns") {
+        PatternTable::shared().load(value);
+    } else if (option == "component-db") {
+        ComponentCache::shared().open(value);
+    } else if (option == "lookahead") {
+        Lookahead::shared().enabled = true;
+        if (*value) {
+            Lookahead::shared().candidates = atoi(value);
+        }
+    } else if (option == "lookahead-threads") {
+        Lookahead::shared().threads = atoi(value);
+    }
+}
@@ -0,0 +1,264 @@
+// ======================================================================
+// FILE:        PatternTable.cpp
+//
+// DESCRIPTION: This file contains the local pattern table: a lookup from
+//              the 5x5 neighborhood around a numbered square to the
+//              squares in it that are forced safe or forced mines.
+// ======================================================================
+
+#include "PatternTable.hpp"
+#include "Frontier.hpp"
+#include <fstream>
+
+// Window square states. Inner squares keep their number; outer squares
+// only matter as variables (covered) or known mines (flagged).
+#define PATTERN_OTHER   0
+#define PATTERN_COVERED 1
+#define PATTERN_FLAGGED 2
+#define PATTERN_NUMBER  3   // + the number, inner squares only
+
+static const char PATTERN_MAGIC[4] = {'M', 'S', 'P', 'T'};
+static const uint32_t PATTERN_VERSION = 1;
+
+PatternTable& PatternTable::shared()
+{
+    static PatternTable table;
+    return table;
+}
+
+namespace {
+
+bool isInner(int dx, int dy)
+{
+    return dx >= -1 && dx <= 1 && dy >= -1 && dy <= 1;
+}
+
+int windowIndex(int dx, int dy)
+{
+    return (dy + PATTERN_RADIUS) * PATTERN_SIDE + (dx + PATTERN_RADIUS);
+}
+
+// Symmetry t of the square, applied to an offset from the center
+void transform(int t, int dx, int dy, int& tx, int& ty)
+{
+    Coord c = applySymmetry(t, Coord(dx, dy));
+    tx = c.x;
+    ty = c.y;
+}
+
+// States of the window around center, by window index
+void readWindow(BoardRep& board, const Coord& center, int states[PATTERN_SQUARES])
+{
+    for (int dy = -PATTERN_RADIUS; dy <= PATTERN_RADIUS; ++dy) {
+        for (int dx = -PATTERN_RADIUS; dx <= PATTERN_RADIUS; ++dx) {
+            Square s = board.getSquare(center.x + dx, center.y + dy);
+            int state = PATTERN_OTHER;
+            if (s == COVERED)
+                state = PATTERN_COVERED;
+            else if (s == FLAGGED)
+                state = PATTERN_FLAGGED;
+            else if (s >= 0 && isInner(dx, dy))
+                state = PATTERN_NUMBER + s;
+            states[windowIndex(dx, dy)] = state;
+        }
+    }
+}
+
+// Key of the window as seen through symmetry t: the square at offset d is
+// written to the position of t(d)
+PatternKey encode(const int states[PATTERN_SQUARES], int t)
+{
+    int placed[PATTERN_SQUARES];
+    for (int dy = -PATTERN_RADIUS; dy <= PATTERN_RADIUS; ++dy) {
+        for (int dx = -PATTERN_RADIUS; dx <= PATTERN_RADIUS; ++dx) {
+            int tx, ty;
+            transform(t, dx, dy, tx, ty);
+            placed[windowIndex(tx, ty)] = states[windowIndex(dx, dy)];
+        }
+    }
+    PatternKey key = {0, 0};
+    for (int dy = -PATTERN_RADIUS; dy <= PATTERN_RADIUS; ++dy) {
+        for (int dx = -PATTERN_RADIUS; dx <= PATTERN_RADIUS; ++dx) {
+            int state = placed[windowIndex(dx, dy)];
+            if (isInner(dx, dy))
+                key.hi = (key.hi << 4) | state;
+            else
+                key.lo = (key.lo << 2) | state;
+        }
+    }
+    return key;
+}
+
+// Solves the window from the constraints of its inner numbers. Masks are
+// indexed like states.
+bool solveWindow(const int states[PATTERN_SQUARES], PatternEntry& entry)
+{
+    FrontierComponent comp;
+    int cell_of[PATTERN_SQUARES];
+    for (int i = 0; i < PATTERN_SQUARES; ++i)
+        cell_of[i] = -1;
+
+    for (int dy = -1; dy <= 1; ++dy) {
+        for (int dx = -1; dx <= 1; ++dx) {
+            int state = states[windowIndex(dx, dy)];
+            if (state < PATTERN_NUMBER)
+                continue;
+            Constraint constraint;
+            constraint.mines = state - PATTERN_NUMBER;
+            constraint.slack = 0;
+            for (int ny = dy-1; ny <= dy+1; ++ny) {
+                for (int nx = dx-1; nx <= dx+1; ++nx) {
+                    int n = windowIndex(nx, ny);
+                    if (states[n] == PATTERN_FLAGGED) {
+                        --constraint.mines;
+                    } else if (states[n] == PATTERN_COVERED) {
+                        if (cell_of[n] < 0) {
+                            cell_of[n] = comp.cells.size();
+                            comp.cells.push_back(Coord(nx, ny));
+                        }
+                        constraint.cells.push_back(cell_of[n]);
+                    }
+                }
+            }
+            comp.constraints.push_back(constraint);
+        }
+    }
+
+    ComponentSolution solution;
+    if (comp.cells.empty() || !solveComponent(comp, solution))
+        return false;
+
+    entry.safe = 0;
+    entry.mines = 0;
+    for (size_t i = 0; i < comp.cells.size(); ++i) {
+        uint32_t bit = 1u << windowIndex(comp.cells[i].x, comp.cells[i].y);
+        if (solution.mine_counts[i] == 0)
+            entry.safe |= bit;
+        else if (solution.mine_counts[i] == solution.total)
+            entry.mines |= bit;
+    }
+    return entry.safe || entry.mines;
+}
+
+}
+
+bool PatternTable::lookup(BoardRep& board, const Coord& center, PatternBuf& safe, PatternBuf& mines)
+{
+    int states[PATTERN_SQUARES];
+    readWindow(board, center, states);
+
+    // canonical orientation: the symmetry with the smallest key
+    int best_t = 0;
+    PatternKey key = encode(states, 0);
+    for (int t = 1; t < 8; ++t) {
+        PatternKey other = encode(states, t);
+        if (other < key) {
+            key = other;
+            best_t = t;
+        }
+    }
+
+    PatternEntry entry;
+    auto it = entries.find(key);
+    if (it != entries.end()) {
+        entry = it->second;
+        ++hits;
+    } else {
+        ++misses;
+        if (!recording)
+            return false;
+        // solve in the canonical orientation so the masks can be stored
+        int canonical[PATTERN_SQUARES];
+        for (int dy = -PATTERN_RADIUS; dy <= PATTERN_RADIUS; ++dy) {
+            for (int dx = -PATTERN_RADIUS; dx <= PATTERN_RADIUS; ++dx) {
+                int tx, ty;
+                transform(best_t, dx, dy, tx, ty);
+                canonical[windowIndex(tx, ty)] = states[windowIndex(dx, dy)];
+            }
+        }
+        if (!solveWindow(canonical, entry))
+            return false;
+        entries[key] = entry;
+    }
+
+    // map the canonical masks back onto the board
+    for (int dy = -PATTERN_RADIUS; dy <= PATTERN_RADIUS; ++dy) {
+        for (int dx = -PATTERN_RADIUS; dx <= PATTERN_RADIUS; ++dx) {
+            int tx, ty;
+            transform(best_t, dx, dy, tx, ty);
+            uint32_t bit = 1u << windowIndex(tx, ty);
+            if (entry.safe & bit)
+                safe.push_back(Coord(center.x + dx, center.y + dy));
+            else if (entry.mines & bit)
+                mines.push_back(Coord(center.x + dx, center.y + dy));
+        }
+    }
+    return true;
+}
+
+// File layout: magic, version, entry count, then for every entry the key
+// (hi, lo) followed by the safe and mine masks. The count must match the
+// bytes that follow, and nothing is merged into the table until every
+// entry has been read.
+bool PatternTable::load(const string& filename)
+{
+    const uint64_t entry_size = 2 * sizeof(uint64_t) + 2 * sizeof(uint32_t);
+    ifstream file(filename, ios::binary);
+    char magic[4];
+    uint32_t version;
+    uint64_t count;
+    file.read(magic, 4);
+    file.read((char*) &version, sizeof(version));
+    file.read((char*) &count, sizeof(count));
+    if (!file || !equal(magic, magic + 4, PATTERN_MAGIC) || version != PATTERN_VERSION)
+        return false;
+    streampos start = file.tellg();
+    file.seekg(0, ios::end);
+    streampos end = file.tellg();
+    file.seekg(start);
+    if (!file || end < start || count != (uint64_t) (end - start) / entry_size
+        || (uint64_t) (end - start) % entry_size != 0)
+        return false;
+
+    unordered_map<PatternKey, PatternEntry, PatternKeyHash> loaded;
+    loaded.reserve(count);
+    for (uint64_t i = 0; i < count; ++i) {
+        PatternKey key;
+        PatternEntry entry;
+        file.read((char*) &key.hi, sizeof(key.hi));
+        file.read((char*) &key.lo, sizeof(key.lo));
+        file.read((char*) &entry.safe, sizeof(entry.safe));
+        file.read((char*) &entry.mines, sizeof(entry.mines));
+        if (!file)
+            return false;
+        loaded[key] = entry;
+    }
+    if (entries.empty()) {
+        entries.swap(loaded);
+    } else {
+        for (const auto& e : loaded)
+            entries[e.first] = e.second;
+    }
+    return true;
+}
+
+bool PatternTable::save(const string& filename) const
+{
+    ofstream file(filename, ios::binary | ios::trunc);
+    uint64_t count = entries.size();
+    file.write(PATTERN_MAGIC, 4);
+    file.write((const char*) &PATTERN_VERSION, sizeof(PATTERN_VERSION));
+    file.write((const char*) &count, sizeof(count));
+
+    // sorted, so the same corpus always produces the same file
+    vector<pair<PatternKey, PatternEntry>> sorted(entries.begin(), entries.end());
+    sort(sorted.begin(), sorted.end(),
+        [](const pair<PatternKey, PatternEntry>& a, const pair<PatternKey, PatternEntry>& b) { return a.first < b.first; });
+    for (const auto& e : sorted) {
+        file.write((const char*) &e.first.hi, sizeof(e.first.hi));
+        file.write((const char*) &e.first.lo, sizeof(e.first.lo));
+        file.write((const char*) &e.second.safe, sizeof(e.second.safe));
+        file.write((const char*) &e.second.mines, sizeof(e.second.mines));
+    }
+    return (bool) file;
+}
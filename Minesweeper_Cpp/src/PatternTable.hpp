@@ -0,0 +1,82 @@
+// ======================================================================
+// FILE:        PatternTable.hpp
+//
+// DESCRIPTION: This file contains the local pattern table: a lookup from
+//              the 5x5 neighborhood around a numbered square to the
+//              squares in it that are forced safe or forced mines.
+//
+// NOTES:       - Only the numbers in the inner 3x3 of a window are used
+//                as constraints, since all of their neighbors lie inside
+//                the window. Any deduction made from them holds no matter
+//                what the rest of the board looks like.
+//
+//              - Windows are reduced by the 8 rotations and reflections
+//                of the square, so one entry covers every orientation of
+//                a pattern.
+//
+//              - Tables are generated offline (see --gen-patterns in
+//                Main.cpp) by solving the windows met while playing a
+//                corpus of worlds, and loaded read-only at startup.
+// ======================================================================
+
+#ifndef MINE_SWEEPER_CPP_SHELL_PATTERNTABLE_HPP
+#define MINE_SWEEPER_CPP_SHELL_PATTERNTABLE_HPP
+
+#include "BoardRep.hpp"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#define PATTERN_RADIUS 2
+#define PATTERN_SIDE (2 * PATTERN_RADIUS + 1)
+#define PATTERN_SQUARES (PATTERN_SIDE * PATTERN_SIDE)
+
+// Canonical window encoding: 4 bits per inner square in hi, 2 bits per
+// outer square in lo
+struct PatternKey {
+    uint64_t hi;
+    uint64_t lo;
+    bool operator==(const PatternKey& other) const { return hi == other.hi && lo == other.lo; }
+    bool operator<(const PatternKey& other) const { return hi != other.hi ? hi < other.hi : lo < other.lo; }
+};
+
+struct PatternKeyHash {
+    size_t operator()(const PatternKey& k) const { return k.hi * 0x9E3779B97F4A7C15ULL ^ k.lo; }
+};
+
+typedef CoordBuf<PATTERN_SQUARES> PatternBuf;
+
+// Forced squares of a window, as bit masks over canonical window indexes
+struct PatternEntry {
+    uint32_t safe;
+    uint32_t mines;
+};
+
+class PatternTable
+{
+public:
+    // The table MyAI consults; empty unless Main loads or records one
+    static PatternTable& shared();
+
+    bool load(const string& filename);
+    bool save(const string& filename) const;
+    size_t size() const { return entries.size(); }
+    bool empty() const { return entries.empty(); }
+
+    // When recording, lookups that miss solve the window and store it
+    bool recording = false;
+
+    // Looks up the window centered on the numbered square at center and
+    // fills safe/mines with the forced squares of the board. Returns false
+    // if the window has no entry and nothing was deduced.
+    bool lookup(BoardRep& board, const Coord& center, PatternBuf& safe, PatternBuf& mines);
+
+    // Lookup statistics
+    long long hits = 0;
+    long long misses = 0;
+
+private:
+    unordered_map<PatternKey, PatternEntry, PatternKeyHash> entries;
+};
+
+#endif //MINE_SWEEPER_CPP_SHELL_PATTERNTABLE_HPP
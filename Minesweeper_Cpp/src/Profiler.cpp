@@ -0,0 +1,257 @@
+// ======================================================================
+// FILE:        Profiler.cpp
+//
+// DESCRIPTION: This file contains the profiler. See Profiler.hpp.
+// ======================================================================
+
+#include "Profiler.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <cmath>
+#include <iomanip>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+thread_local uint64_t profile_alloc_count = 0;
+thread_local uint64_t profile_alloc_bytes = 0;
+bool profile_alloc_counting = false;
+bool profile_alloc_linked = false;
+
+// ===============================================================
+// =                         Profiler
+// ===============================================================
+
+namespace {
+
+const char* PHASE_NAMES[PROFILE_PHASES] = {
+    "game", "agent", "pattern", "component", "endgame", "regions", "exact", "sloppy", "lookahead",
+    "sweep"
+};
+
+struct CounterEvent {
+    ProfileValue value;
+    uint64_t config;
+    const char* name;
+};
+
+const CounterEvent COUNTER_EVENTS[] = {
+    {PROFILE_CYCLES,        PERF_COUNT_HW_CPU_CYCLES,       "cycles"},
+    {PROFILE_INSTRUCTIONS,  PERF_COUNT_HW_INSTRUCTIONS,     "instructions"},
+    {PROFILE_LLC_MISSES,    PERF_COUNT_HW_CACHE_MISSES,     "LLC misses"},
+    {PROFILE_BRANCH_MISSES, PERF_COUNT_HW_BRANCH_MISSES,    "branch misses"},
+};
+
+uint64_t nowNanos()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}
+
+Profiler& Profiler::shared()
+{
+    static Profiler profiler;
+    return profiler;
+}
+
+Profiler::~Profiler()
+{
+    for (int fd : counter_fds) {
+        close(fd);
+    }
+}
+
+void Profiler::enable()
+{
+    enabled = true;
+    available[PROFILE_NANOS] = true;
+    available[PROFILE_ALLOCS] = profile_alloc_linked;
+    available[PROFILE_ALLOC_BYTES] = profile_alloc_linked;
+    profile_alloc_counting = profile_alloc_linked;
+    if (!counter_fds.empty()) {
+        return;
+    }
+
+    for (const CounterEvent& event : COUNTER_EVENTS) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = event.config;
+        attr.disabled = group_fd < 0;       // the group starts when its leader is enabled
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        int fd = (int) syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0);
+        if (fd < 0) {
+            if (unavailable_reason.empty()) {
+                unavailable_reason = strerror(errno);
+            }
+            unavailable += string(unavailable.empty() ? "" : ", ") + event.name;
+            continue;
+        }
+        if (group_fd < 0) {
+            group_fd = fd;
+        }
+        counter_fds.push_back(fd);
+        counter_value.push_back(event.value);
+        available[event.value] = true;
+    }
+    if (group_fd < 0) {
+        return;
+    }
+    buffer.assign(3 + counter_fds.size(), 0);
+    ioctl(group_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+void Profiler::read(ProfileSample& sample)
+{
+    memset(&sample, 0, sizeof(sample));
+    if (group_fd >= 0 && ::read(group_fd, buffer.data(), buffer.size() * sizeof(uint64_t)) > 0) {
+        // nr, time enabled, time running, then one value per counter
+        sample.enabled = buffer[1];
+        sample.running = buffer[2];
+        for (size_t i = 0; i < counter_value.size() && i < buffer[0]; ++i) {
+            sample.value[counter_value[i]] = buffer[3 + i];
+        }
+    }
+    sample.value[PROFILE_ALLOCS] = profile_alloc_count;
+    sample.value[PROFILE_ALLOC_BYTES] = profile_alloc_bytes;
+    sample.value[PROFILE_NANOS] = nowNanos();
+}
+
+void Profiler::end(ProfilePhase phase, const ProfileSample& start)
+{
+    ProfileSample now;
+    read(now);
+    ProfileSample delta;
+    for (int v = 0; v < PROFILE_VALUES; ++v) {
+        delta.value[v] = now.value[v] - start.value[v];
+    }
+    delta.enabled = now.enabled - start.enabled;
+    delta.running = now.running - start.running;
+
+    // counters the kernel multiplexed only counted part of the time
+    if (delta.running && delta.running < delta.enabled) {
+        double scale = (double) delta.enabled / delta.running;
+        for (int value : counter_value) {
+            delta.value[value] = (uint64_t) (delta.value[value] * scale);
+        }
+    }
+
+    PhaseTotal& total = phases[phase];
+    ++total.calls;
+    for (int v = 0; v < PROFILE_VALUES; ++v) {
+        total.value[v] += delta.value[v];
+    }
+    if (phase == PROFILE_GAME) {
+        games.push_back(delta);
+    }
+}
+
+// ===============================================================
+// =                          Report
+// ===============================================================
+
+void Profiler::report(ostream& out) const
+{
+    out << endl << "Profile";
+    if (counter_fds.empty()) {
+        out << " (hardware counters unavailable: " << unavailable_reason << ")";
+    } else if (!unavailable.empty()) {
+        out << " (" << unavailable << " unavailable: " << unavailable_reason << ")";
+    }
+    out << endl;
+    reportPhases(out);
+    reportGames(out);
+}
+
+void Profiler::reportPhases(ostream& out) const
+{
+    out << left << setw(12) << "phase" << right << setw(10) << "calls" << setw(12) << "ms"
+        << setw(12) << "Mcycles" << setw(12) << "Minstr" << setw(7) << "IPC"
+        << setw(12) << "LLC miss" << setw(12) << "br miss" << setw(12) << "allocs" << setw(10) << "MB" << endl;
+
+    for (int p = 0; p < PROFILE_PHASES; ++p) {
+        const PhaseTotal& total = phases[p];
+        if (!total.calls) {
+            continue;
+        }
+        const uint64_t* v = total.value;
+        out << left << setw(12) << PHASE_NAMES[p] << right << setw(10) << total.calls
+            << fixed << setprecision(1) << setw(12) << v[PROFILE_NANOS] / 1e6;
+        if (available[PROFILE_CYCLES]) {
+            out << setw(12) << v[PROFILE_CYCLES] / 1e6;
+        } else {
+            out << setw(12) << "n/a";
+        }
+        if (available[PROFILE_INSTRUCTIONS]) {
+            out << setw(12) << v[PROFILE_INSTRUCTIONS] / 1e6;
+        } else {
+            out << setw(12) << "n/a";
+        }
+        if (available[PROFILE_CYCLES] && available[PROFILE_INSTRUCTIONS] && v[PROFILE_CYCLES]) {
+            out << setprecision(2) << setw(7) << (double) v[PROFILE_INSTRUCTIONS] / v[PROFILE_CYCLES];
+        } else {
+            out << setw(7) << "n/a";
+        }
+        for (int value : {PROFILE_LLC_MISSES, PROFILE_BRANCH_MISSES}) {
+            if (available[value]) {
+                out << setw(12) << v[value];
+            } else {
+                out << setw(12) << "n/a";
+            }
+        }
+        out << setw(12) << v[PROFILE_ALLOCS] << setprecision(1) << setw(10) << v[PROFILE_ALLOC_BYTES] / 1e6 << endl;
+    }
+}
+
+void Profiler::reportGames(ostream& out) const
+{
+    if (games.empty()) {
+        return;
+    }
+    out << endl << "Per game (" << games.size() << " games)" << endl;
+    out << left << setw(16) << "" << right << setw(14) << "mean" << setw(14) << "min" << setw(14) << "p50"
+        << setw(14) << "p90" << setw(14) << "p99" << setw(14) << "max" << endl;
+
+    struct Row {
+        ProfileValue value;
+        const char* name;
+        double unit;
+    };
+    const Row rows[] = {
+        {PROFILE_NANOS,         "ms",           1e6},
+        {PROFILE_CYCLES,        "Mcycles",      1e6},
+        {PROFILE_INSTRUCTIONS,  "Minstr",       1e6},
+        {PROFILE_LLC_MISSES,    "LLC misses",   1},
+        {PROFILE_BRANCH_MISSES, "branch misses", 1},
+        {PROFILE_ALLOCS,        "allocs",       1},
+        {PROFILE_ALLOC_BYTES,   "KB allocated", 1e3},
+    };
+
+    vector<double> sorted(games.size());
+    for (const Row& row : rows) {
+        if (!available[row.value]) {
+            continue;
+        }
+        double sum = 0;
+        for (size_t g = 0; g < games.size(); ++g) {
+            sorted[g] = games[g].value[row.value] / row.unit;
+            sum += sorted[g];
+        }
+        sort(sorted.begin(), sorted.end());
+        // nearest rank
+        auto at = [&sorted](double q) { return sorted[max<size_t>(1, (size_t) ceil(q * sorted.size())) - 1]; };
+        out << left << setw(16) << row.name << right << fixed << setprecision(row.unit > 1 ? 3 : 0)
+            << setw(14) << sum / sorted.size() << setw(14) << sorted.front() << setw(14) << at(0.5)
+            << setw(14) << at(0.9) << setw(14) << at(0.99) << setw(14) << sorted.back() << endl;
+    }
+}
@@ -0,0 +1,138 @@
+// ======================================================================
+// FILE:        Profiler.hpp
+//
+// DESCRIPTION: This file contains the profiler: hardware counters,
+//              wall time and allocation counts around the game loop and
+//              MyAI's solver phases, reported per phase and per game at
+//              the end of a run.
+//
+// NOTES:       - Off unless Main enables it (--profile). A ProfileScope
+//                placed at the top of a function reads every counter when
+//                the function starts and adds the difference to its phase
+//                when it returns. Phases nest, so each total includes the
+//                phases inside it (the game includes the agent, the agent
+//                includes the solvers).
+//
+//              - The counters are Linux perf_event_open events for this
+//                thread, user space only: cycles, instructions, last level
+//                cache misses and branch misses. They are read as one
+//                group, scaled if the kernel had to multiplex them. Any
+//                event that can't be opened (no PMU in a VM, or
+//                perf_event_paranoid too high) is reported as n/a; time
+//                and allocations are always measured.
+//
+//              - Allocations are counted, per thread, by the global
+//                operator new and delete of AllocCount.cpp, and only once
+//                the profiler is enabled. Only the Minesweeper binary
+//                links that file; the agent plugin and the solver library
+//                keep the standard allocator and report allocations n/a.
+// ======================================================================
+
+#ifndef MINE_SWEEPER_CPP_SHELL_PROFILER_HPP
+#define MINE_SWEEPER_CPP_SHELL_PROFILER_HPP
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+enum ProfilePhase {
+    PROFILE_GAME,           // World::run, or one replayed game
+    PROFILE_AGENT,          // MyAI::getAction / getActions
+    PROFILE_PATTERN,
+    PROFILE_COMPONENT,
+    PROFILE_ENDGAME,
+    PROFILE_REGIONS,
+    PROFILE_EXACT,
+    PROFILE_SLOPPY,
+    PROFILE_LOOKAHEAD,
+    PROFILE_SWEEP,
+    PROFILE_PHASES
+};
+
+// What a sample holds, in order
+enum ProfileValue {
+    PROFILE_NANOS,
+    PROFILE_CYCLES,
+    PROFILE_INSTRUCTIONS,
+    PROFILE_LLC_MISSES,
+    PROFILE_BRANCH_MISSES,
+    PROFILE_ALLOCS,
+    PROFILE_ALLOC_BYTES,
+    PROFILE_VALUES
+};
+
+// Allocations of this thread while profile_alloc_counting is set, counted
+// by AllocCount.cpp when it is linked (profile_alloc_linked)
+extern thread_local uint64_t profile_alloc_count;
+extern thread_local uint64_t profile_alloc_bytes;
+extern bool profile_alloc_counting;
+extern bool profile_alloc_linked;
+
+struct ProfileSample {
+    uint64_t value[PROFILE_VALUES];
+    uint64_t enabled;       // kernel time the counter group was enabled
+    uint64_t running;       // and actually counting
+};
+
+class Profiler
+{
+public:
+    // The profiler the game loop and MyAI report to
+    static Profiler& shared();
+
+    ~Profiler();
+
+    bool enabled = false;
+    void enable();          // opens the counters; enabled stays true if they fail
+
+    void read ( ProfileSample& sample );
+    void end ( ProfilePhase phase, const ProfileSample& start );
+
+    void report ( ostream& out ) const;
+
+private:
+    struct PhaseTotal {
+        long long calls = 0;
+        uint64_t value[PROFILE_VALUES] = {0};
+    };
+
+    void reportPhases ( ostream& out ) const;
+    void reportGames ( ostream& out ) const;
+
+    int group_fd = -1;                  // leader of the counter group, or -1
+    vector<int> counter_fds;
+    vector<int> counter_value;          // ProfileValue of each open counter, in group order
+    bool available[PROFILE_VALUES] = {false};
+    string unavailable;                 // counters that failed to open
+    string unavailable_reason;          // the first failure
+    vector<uint64_t> buffer;            // group read buffer
+
+    PhaseTotal phases[PROFILE_PHASES];
+    vector<ProfileSample> games;        // one difference per game
+};
+
+// Measures the enclosing block as 'phase' when profiling is enabled
+class ProfileScope
+{
+public:
+    explicit ProfileScope ( ProfilePhase _phase ) : phase(_phase), active(Profiler::shared().enabled) {
+        if (active) {
+            Profiler::shared().read(start);
+        }
+    }
+    ~ProfileScope() {
+        if (active) {
+            Profiler::shared().end(phase, start);
+        }
+    }
+
+private:
+    ProfilePhase phase;
+    bool active;
+    ProfileSample start;
+};
+
+#endif //MINE_SWEEPER_CPP_SHELL_PROFILER_HPP
@@ -17,7 +17,7 @@
 #include "Agent.hpp"
 #include<iostream>
 
-class RandomAI : public Agent
+class RandomAI final : public Agent
 {
 public:
 
@@ -28,7 +28,7 @@ public:
 
     Action getAction( int number) override
     {
-        return{actions[rand() % 4], rand() % rowDimension, rand() % colDimension};
+        return{actions[rand() % 4], rand() % colDimension, rand() % rowDimension};
     }
 
 private:
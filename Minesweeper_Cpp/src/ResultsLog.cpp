@@ -0,0 +1,122 @@
+// ======================================================================
+// FILE:        ResultsLog.cpp
+//
+// DESCRIPTION: This file contains the results log. See ResultsLog.hpp.
+// ======================================================================
+
+#include "ResultsLog.hpp"
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+bool ResultsLog::open(const string& filename, bool resume)
+{
+    results.clear();
+    pending.clear();
+    bool empty = true;
+    if (resume) {
+        ifstream existing(filename, ios::ate);
+        empty = !existing || existing.tellg() <= 0;
+        load(filename);
+    }
+    file.open(filename, resume ? ios::app : ios::trunc);
+    if (!file) {
+        return false;
+    }
+    if (empty) {
+        file << "# world\toutcome\tscore\tmoves\tms\tpeak_frontier\n";
+    }
+    if (pending.size()) {
+        // close the line the last run left open and record the crash
+        WorldResult crash;
+        crash.world = pending.substr(0, pending.find('\t'));
+        crash.outcome = "crash";
+        if (pending != crash.world + "\t") {
+            file << "\n" << crash.world << "\t";     // more than begin() wrote
+        }
+        finish(crash);
+        pending.clear();
+    }
+    file.flush();
+    return (bool) file;
+}
+
+void ResultsLog::load(const string& filename)
+{
+    ifstream in(filename);
+    string line;
+    while (getline(in, line)) {
+        if (in.eof()) {
+            // no newline after it: the run stopped while playing this world
+            pending = line;
+            break;
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        vector<string> fields;
+        istringstream split(line);
+        string field;
+        while (getline(split, field, '\t')) {
+            fields.push_back(field);
+        }
+        if (fields.size() != 6) {
+            continue;
+        }
+        WorldResult result;
+        result.world = fields[0];
+        result.outcome = fields[1];
+        result.score = atoi(fields[2].c_str());
+        result.moves = atoi(fields[3].c_str());
+        result.ms = atof(fields[4].c_str());
+        result.peakFrontier = atoi(fields[5].c_str());
+        results[result.world] = result;
+    }
+}
+
+const WorldResult* ResultsLog::find(const string& world) const
+{
+    auto it = results.find(world);
+    return it == results.end() ? nullptr : &it->second;
+}
+
+void ResultsLog::begin(const string& world)
+{
+    lock_guard<mutex> guard(lock);
+    file << world << "\t";
+    file.flush();
+    playing = world;
+    playingSince = chrono::steady_clock::now();
+}
+
+void ResultsLog::finish(const WorldResult& result)
+{
+    {
+        lock_guard<mutex> guard(lock);
+        write(result);
+        playing.clear();
+    }
+    results[result.world] = result;
+}
+
+void ResultsLog::abandon(const string& outcome)
+{
+    lock_guard<mutex> guard(lock);
+    if (playing.empty()) {
+        return;
+    }
+    WorldResult result;
+    result.world = playing;
+    result.outcome = outcome;
+    result.ms = chrono::duration<double, milli>(chrono::steady_clock::now() - playingSince).count();
+    write(result);
+    playing.clear();
+}
+
+// The rest of the line begin() started
+void ResultsLog::write(const WorldResult& result)
+{
+    file << result.outcome << "\t" << result.score << "\t" << result.moves << "\t"
+         << fixed << setprecision(3) << result.ms << "\t" << result.peakFrontier << "\n";
+    file.flush();
+}
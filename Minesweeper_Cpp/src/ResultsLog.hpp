@@ -0,0 +1,85 @@
+// ======================================================================
+// FILE:        ResultsLog.hpp
+//
+// DESCRIPTION: This file contains the results log of a folder run: one
+//              line per world, appended and flushed as soon as the world
+//              is played, so a long run can be watched with tail -f and
+//              picked up again after it stops.
+//
+// NOTES:       - Tab-separated, one world per line:
+//
+//                  <world> <outcome> <score> <moves> <ms> <peak frontier>
+//
+//                outcome is win, loss, error (the world threw), timeout
+//                (the watchdog stopped the game, see Watchdog.hpp) or
+//                crash (the run died while playing it). moves, ms and
+//                peak frontier are -1 when unknown.
+//
+//              - begin() writes the world's name before it is played and
+//                finish() completes the line. When a run dies mid-world,
+//                its line is left unterminated; open() with resume
+//                records that world as a crash, so the next run doesn't
+//                play it again and die the same way.
+//
+//              - A watchdog forfeit (Watchdog.hpp) ends the run from the
+//                monitor thread while the main thread may be writing the
+//                log. The log is locked around every write, and abandon()
+//                completes the open line itself, from what begin()
+//                recorded, so the two threads never share a result.
+//
+//              - Lines starting with '#' and malformed lines are ignored.
+// ======================================================================
+
+#ifndef MINE_SWEEPER_CPP_SHELL_RESULTSLOG_HPP
+#define MINE_SWEEPER_CPP_SHELL_RESULTSLOG_HPP
+
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+using namespace std;
+
+struct WorldResult {
+    string  world;              // file name within the folder
+    string  outcome;            // win, loss, error, timeout or crash
+    int     score = 0;
+    int     moves = -1;
+    double  ms = -1;            // wall time of reset and run
+    int     peakFrontier = -1;
+};
+
+class ResultsLog
+{
+public:
+    // Opens the log for appending. With resume, the worlds already in it
+    // are loaded first; without, the file is started over.
+    bool open ( const string& filename, bool resume );
+
+    // The recorded result of a world, or nullptr if it hasn't been played
+    const WorldResult* find ( const string& world ) const;
+
+    void begin ( const string& world );
+    void finish ( const WorldResult& result );
+
+    // Completes the line of the world begun but not finished, if any, as
+    // 'outcome', timed from begin(). Safe from another thread; for a run
+    // about to exit, so the world isn't added to what find() sees.
+    void abandon ( const string& outcome );
+
+    size_t recorded () const { return results.size(); }
+
+private:
+    void load ( const string& filename );
+    void write ( const WorldResult& result );
+
+    mutex lock;                 // held around every write to file
+    ofstream file;
+    unordered_map<string, WorldResult> results;
+    string pending;             // unterminated last line of the file
+    string playing;             // world begun and not finished, or empty
+    chrono::steady_clock::time_point playingSince;
+};
+
+#endif //MINE_SWEEPER_CPP_SHELL_RESULTSLOG_HPP
@@ -0,0 +1,73 @@
+// ======================================================================
+// FILE:        SolverJNI.cpp
+//
+// DESCRIPTION: This file contains the JNI side of the Java shell's
+//              NativeSolver class (Minesweeper_Java/src/NativeSolver.java):
+//              each native method forwards to the C API of SolverLib.hpp.
+//              'make solverlib' links it into bin/libminesolver.so when
+//              JAVA_HOME is set.
+//
+// NOTES:       - Agents cross as a long holding the MsAgent pointer.
+//                Coordinates are passed through unchanged; the Java side
+//                converts between its 1-based squares and the library's.
+// ======================================================================
+
+#include "SolverLib.hpp"
+#include <jni.h>
+
+#define JNI_EXPORT extern "C" JNIEXPORT
+
+JNI_EXPORT jint JNICALL Java_src_NativeSolver_abi(JNIEnv*, jclass)
+{
+    return ms_solver_abi();
+}
+
+JNI_EXPORT void JNICALL Java_src_NativeSolver_configure(JNIEnv* env, jclass, jstring name, jstring value)
+{
+    const char* n = env->GetStringUTFChars(name, nullptr);
+    const char* v = env->GetStringUTFChars(value, nullptr);
+    ms_solver_configure(n, v);
+    env->ReleaseStringUTFChars(value, v);
+    env->ReleaseStringUTFChars(name, n);
+}
+
+JNI_EXPORT jlong JNICALL Java_src_NativeSolver_create(JNIEnv*, jclass, jint rows, jint cols, jint mines,
+                                                     jint startX, jint startY)
+{
+    return (jlong) ms_agent_create(rows, cols, mines, startX, startY);
+}
+
+JNI_EXPORT jboolean JNICALL Java_src_NativeSolver_reset(JNIEnv*, jclass, jlong agent, jint rows, jint cols,
+                                                       jint mines, jint startX, jint startY)
+{
+    return ms_agent_reset((MsAgent*) agent, rows, cols, mines, startX, startY) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNI_EXPORT void JNICALL Java_src_NativeSolver_destroy(JNIEnv*, jclass, jlong agent)
+{
+    ms_agent_destroy((MsAgent*) agent);
+}
+
+// The action code, with its square in xy[0] and xy[1]
+JNI_EXPORT jint JNICALL Java_src_NativeSolver_getAction(JNIEnv* env, jclass, jlong agent, jint number, jintArray xy)
+{
+    int x, y;
+    int action = ms_agent_get_action((MsAgent*) agent, number, &x, &y);
+    jint square[2] = { x, y };
+    env->SetIntArrayRegion(xy, 0, 2, square);
+    return action;
+}
+
+JNI_EXPORT jint JNICALL Java_src_NativeSolver_solve(JNIEnv* env, jclass, jint rows, jint cols, jint mines,
+                                                   jintArray squares, jdoubleArray mineProbability)
+{
+    if (env->GetArrayLength(squares) < rows * cols || env->GetArrayLength(mineProbability) < rows * cols) {
+        return -1;
+    }
+    jint* board = env->GetIntArrayElements(squares, nullptr);
+    jdouble* probability = env->GetDoubleArrayElements(mineProbability, nullptr);
+    int certain = ms_solve(rows, cols, mines, (const int*) board, (double*) probability);
+    env->ReleaseDoubleArrayElements(mineProbability, probability, 0);
+    env->ReleaseIntArrayElements(squares, board, JNI_ABORT);
+    return certain;
+}
@@ -0,0 +1,183 @@
+// ======================================================================
+// FILE:        SolverLib.cpp
+//
+// DESCRIPTION: This file contains the native solver library. See
+//              SolverLib.hpp.
+// ======================================================================
+
+#include "SolverLib.hpp"
+#include "MyAI.hpp"
+#include <cstdlib>
+
+struct MsAgent {
+    MsAgent(int rows, int cols, int mines, int startX, int startY) : ai(rows, cols, mines, startX, startY) {}
+    MyAI ai;
+};
+
+namespace {
+
+bool validBoard(int rows, int cols, int mines, int startX, int startY)
+{
+    return rows > 0 && cols > 0 && mines >= 0 && mines < (long long) rows * cols
+        && startX >= 0 && startX < cols && startY >= 0 && startY < rows;
+}
+
+}
+
+int ms_solver_abi(void)
+{
+    return MS_SOLVER_ABI;
+}
+
+void ms_solver_configure(const char* name, const char* value)
+{
+    string option = name;
+    if (option == "patterns") {
+        PatternTable::shared().load(value);
+    } else if (option == "component-db") {
+        ComponentCache::shared().open(value);
+    } else if (option == "lookahead") {
+        Lookahead::shared().enabled = true;
+        if (*value) {
+            Lookahead::shared().candidates = atoi(value);
+        }
+    } else if (option == "lookahead-threads") {
+        Lookahead::shared().threads = atoi(value);
+    }
+}
+
+MsAgent* ms_agent_create(int rows, int cols, int mines, int startX, int startY)
+{
+    if (!validBoard(rows, cols, mines, startX, startY)) {
+        return nullptr;
+    }
+    return new MsAgent(rows, cols, mines, startX, startY);
+}
+
+int ms_agent_reset(MsAgent* agent, int rows, int cols, int mines, int startX, int startY)
+{
+    if (!agent || !validBoard(rows, cols, mines, startX, startY)) {
+        return 0;
+    }
+    agent->ai.reset(rows, cols, mines, startX, startY);
+    return 1;
+}
+
+void ms_agent_destroy(MsAgent* agent)
+{
+    delete agent;
+}
+
+int ms_agent_get_action(MsAgent* agent, int number, int* x, int* y)
+{
+    Agent::Action action = agent->ai.getAction(number);
+    *x = action.x;
+    *y = action.y;
+    return action.action;
+}
+
+int ms_solve(int rows, int cols, int mines, const int* squares, double* mine_probability)
+{
+    if (!validBoard(rows, cols, mines, 0, 0) || !squares || !mine_probability) {
+        return -1;
+    }
+    BoardRep board(rows, cols, mines);
+    int flagged = 0;
+    for (int y = 0; y < rows; ++y) {
+        for (int x = 0; x < cols; ++x) {
+            int square = squares[(size_t) y * cols + x];
+            if (square < MS_FLAGGED || square > 8) {
+                return -1;
+            }
+            if (square == MS_FLAGGED) {
+                board.updateSquare(x, y, FLAGGED);
+                ++flagged;
+            } else if (square >= 0) {
+                board.updateSquare(x, y, square);
+            }
+        }
+    }
+
+    // covered squares next to a number, as MyAI keeps them
+    for (int y = 0; y < rows; ++y) {
+        for (int x = 0; x < cols; ++x) {
+            if (board.getSquare(x, y) != COVERED) {
+                continue;
+            }
+            bool frontier = false;
+            for (int i = x-1; i <= x+1 && !frontier; ++i) {
+                for (int j = y-1; j <= y+1 && !frontier; ++j) {
+                    frontier = board.getSquare(i, j) >= 0;
+                }
+            }
+            if (frontier) {
+                board.frontier_covered.insert(Coord(x, y));
+            }
+        }
+    }
+
+    int unknown = 0;
+    for (int y = 0; y < rows; ++y) {
+        for (int x = 0; x < cols; ++x) {
+            Square square = board.getSquare(x, y);
+            mine_probability[(size_t) y * cols + x] = square == FLAGGED ? 1 : square == COVERED ? -1 : 0;
+            unknown += square == COVERED;
+        }
+    }
+
+    FrontierRegions regions;
+    regions.setup(rows, cols, board.large);
+    regions.split(board, MS_SOLVE_MAX_COMPONENT);
+    ComponentSolution solution;
+    int certain = 0;
+    double frontier_mines = 0;
+    int fewest = 0, most = 0;       // mines the frontier can hold, summed over components
+    for (const FrontierComponent& comp : regions.components) {
+        int low, high;
+        if (!solveComponent(comp, solution) || !componentMineRange(comp, low, high)) {
+            return -1;
+        }
+        fewest += low;
+        most += high;
+        for (size_t i = 0; i < comp.cells.size(); ++i) {
+            double p = solution.mine_counts[i] / solution.total;
+            mine_probability[(size_t) comp.cells[i].y * cols + comp.cells[i].x] = p;
+            frontier_mines += p;
+            certain += p == 0 || p == 1;
+        }
+    }
+
+    // the squares off the frontier hold what the frontier leaves, so
+    // their answer is only certain when every solution leaves none or
+    // fills them all
+    int left = mines - flagged;
+    int interior = unknown - (int) board.frontier_covered.size();
+    if (fewest > left || most + interior < left) {
+        return -1;
+    }
+    if (interior > 0) {
+        double p;
+        if (fewest == left) {
+            p = 0;
+        } else if (most + interior == left) {
+            p = 1;
+        } else {
+            // the even share of what the frontier is expected to leave,
+            // kept within the mines the solutions can leave and half a
+            // mine off the certain ends, which nothing here proves
+            double low = max(left - most, 0);
+            double high = min(left - fewest, interior);
+            low = low > 0 ? low : 0.5;
+            high = high < interior ? high : interior - 0.5;
+            p = (left - frontier_mines) / interior;
+            p = min(max(p, low / interior), high / interior);
+        }
+        for (int k = 0; k < rows * cols; ++k) {
+            if (mine_probability[k] < 0) {
+                mine_probability[k] = p;
+            }
+        }
+        certain += (p == 0 || p == 1) ? interior : 0;
+    }
+    return certain;
+}
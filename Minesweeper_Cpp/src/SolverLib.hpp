@@ -0,0 +1,93 @@
+// ======================================================================
+// FILE:        SolverLib.hpp
+//
+// DESCRIPTION: This file contains the C API of the native solver library
+//              ('make solverlib' builds it into bin/libminesolver.so), so
+//              the Python and Java shells can play with MyAI's solver
+//              at native speed instead of reimplementing it.
+//
+// NOTES:       - Two levels of use:
+//
+//                  ms_agent_*   MyAI itself, behind a handle: a shell's
+//                               agent forwards its constructor and
+//                               getAction to it.
+//                  ms_solve     One position in, the chance every square
+//                               is a mine out, for agents that make their
+//                               own decisions from it.
+//
+//              - Coordinates are the C++ shell's: 0-based, x the column
+//                and y the row, row 0 at the bottom. Boards passed to
+//                ms_solve are indexed [y * cols + x] and hold MS_COVERED,
+//                MS_FLAGGED or the number uncovered (0-8). Flags are
+//                trusted as mines.
+//
+//              - ms_solve gives each frontier square its share of the
+//                consistent assignments of its component, as MyAI's
+//                engines do, without weighing them by the mine count.
+//                Components over MS_SOLVE_MAX_COMPONENT squares are cut,
+//                so their chances are bounds but a 0 or 1 is still
+//                certain. Squares off the frontier share the mines the
+//                frontier is not expected to hold; they count as certain
+//                only when the fewest (or most) mines the frontier's
+//                solutions can hold leave none of them (or all of them)
+//                a choice, and a board whose mine count no solution fits
+//                returns -1.
+//
+//              - The header is plain C and only the functions below are
+//                exported (SolverLib.map, checked by 'make solverlib';
+//                plus the JNI methods with JAVA_HOME set). The library
+//                keeps the standard allocator. ms_solver_abi returns
+//                MS_SOLVER_ABI; bindings check it and refuse a library
+//                they weren't written for.
+//                Bump it whenever a signature or meaning below changes.
+//
+//              - ms_solver_configure takes the long options that change
+//                how MyAI plays (patterns, component-db, lookahead,
+//                lookahead-threads), as an agent plugin's configure does.
+//                The library is not thread-safe: one thread at a time.
+// ======================================================================
+
+#ifndef MINE_SWEEPER_CPP_SHELL_SOLVERLIB_HPP
+#define MINE_SWEEPER_CPP_SHELL_SOLVERLIB_HPP
+
+#define MS_SOLVER_ABI 1
+
+#define MS_COVERED -1
+#define MS_FLAGGED -2
+
+// Largest frontier component ms_solve enumerates in one piece
+#define MS_SOLVE_MAX_COMPONENT 32
+
+#define MS_SOLVER_EXPORT __attribute__((visibility("default")))
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct MsAgent MsAgent;
+
+MS_SOLVER_EXPORT int ms_solver_abi ( void );
+MS_SOLVER_EXPORT void ms_solver_configure ( const char* name, const char* value );
+
+// NULL if the board is invalid
+MS_SOLVER_EXPORT MsAgent* ms_agent_create ( int rows, int cols, int mines, int startX, int startY );
+// Starts a new game with the same agent and its buffers; 0 if the board
+// is invalid
+MS_SOLVER_EXPORT int ms_agent_reset ( MsAgent* agent, int rows, int cols, int mines, int startX, int startY );
+MS_SOLVER_EXPORT void ms_agent_destroy ( MsAgent* agent );
+
+// MyAI's next action, given the number uncovered by its last action (or
+// -1): 0 LEAVE, 1 UNCOVER, 2 FLAG, 3 UNFLAG, with its square in x and y
+MS_SOLVER_EXPORT int ms_agent_get_action ( MsAgent* agent, int number, int* x, int* y );
+
+// Fills mine_probability (indexed like squares) with the chance each
+// square is a mine: 0 for uncovered squares, 1 for flags. Returns the
+// covered, unflagged squares whose answer is certain (0 or 1), or -1 if
+// the arguments are invalid or no placement of mines fits the numbers.
+MS_SOLVER_EXPORT int ms_solve ( int rows, int cols, int mines, const int* squares, double* mine_probability );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //MINE_SWEEPER_CPP_SHELL_SOLVERLIB_HPP
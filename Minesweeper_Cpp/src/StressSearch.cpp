@@ -0,0 +1,232 @@
+// ======================================================================
+// FILE:        StressSearch.cpp
+//
+// DESCRIPTION: This file contains the stress world search. See
+//              StressSearch.hpp.
+// ======================================================================
+
+#include "StressSearch.hpp"
+#include "World.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sys/stat.h>
+#include <vector>
+
+namespace {
+
+// A world: mines row-major, row 0 at the bottom, and the 0-based start
+struct Layout {
+    vector<char> mines;
+    int startX = 0;
+    int startY = 0;
+};
+
+struct Scored {
+    Layout layout;
+    long long nodes = 0;
+    double ms = 0;
+    double cost = 0;
+    int peakFrontier = 0;       // breaks ties, so the climb can cross worlds the engines solve cheaply
+
+    bool costlierThan(const Scored& other) const {
+        return cost > other.cost || (cost == other.cost && peakFrontier > other.peakFrontier);
+    }
+    bool sameCost(const Scored& other) const {
+        return cost == other.cost && peakFrontier == other.peakFrontier;
+    }
+};
+
+class StressSearch
+{
+public:
+    StressSearch(const string& _folder, const StressOptions& _options)
+        : folder(_folder), options(_options), rng(_options.seed) {}
+    ~StressSearch() { delete world; }
+
+    bool run(ostream& out);
+
+private:
+    bool inStartPatch(const Layout& layout, int i) const {
+        int x = i % options.cols, y = i / options.cols;
+        return abs(x - layout.startX) <= 1 && abs(y - layout.startY) <= 1;
+    }
+    int randomInt(int limit) { return uniform_int_distribution<int>(0, limit - 1)(rng); }
+
+    void randomLayout(Layout& layout);
+    void mutate(const Layout& from, Layout& to);
+    bool write(const Layout& layout, const string& filename) const;
+    bool play(const Layout& layout, Scored& scored);
+    void remember(const Scored& scored);
+
+    string folder;
+    StressOptions options;
+    mt19937 rng;
+    World* world = nullptr;
+    vector<Scored> worst;       // costliest distinct layouts, costliest first
+};
+
+void StressSearch::randomLayout(Layout& layout)
+{
+    layout.mines.assign(options.rows * options.cols, 0);
+    layout.startX = randomInt(options.cols);
+    layout.startY = randomInt(options.rows);
+    for (int placed = 0; placed < options.mines; ) {
+        int i = randomInt(options.rows * options.cols);
+        if (!layout.mines[i] && !inStartPatch(layout, i)) {
+            layout.mines[i] = 1;
+            ++placed;
+        }
+    }
+}
+
+// Moves 1 to options.moves mines to squares that are empty and outside
+// the start patch. Leaves the layout as it is when there is no such
+// square: every square outside the patch is a mine.
+void StressSearch::mutate(const Layout& from, Layout& to)
+{
+    to = from;
+    int free = 0;
+    for (int i = 0; i < options.rows * options.cols; ++i) {
+        free += !to.mines[i] && !inStartPatch(to, i);
+    }
+    if (!free) {
+        return;
+    }
+    int count = 1 + randomInt(options.moves);
+    for (int m = 0; m < count; ++m) {
+        int mine, empty;
+        do {
+            mine = randomInt(options.rows * options.cols);
+        } while (!to.mines[mine]);
+        do {
+            empty = randomInt(options.rows * options.cols);
+        } while (to.mines[empty] || inStartPatch(to, empty));
+        to.mines[mine] = 0;
+        to.mines[empty] = 1;
+    }
+}
+
+bool StressSearch::write(const Layout& layout, const string& filename) const
+{
+    ofstream file(filename);
+    file << options.rows << " " << options.cols << "\n";
+    file << layout.startX + 1 << " " << layout.startY + 1 << "\n";
+    for (int y = options.rows - 1; y >= 0; --y) {
+        for (int x = 0; x < options.cols; ++x) {
+            file << (layout.mines[y * options.cols + x] ? "1 " : "0 ");
+        }
+        file << "\n";
+    }
+    return (bool) file;
+}
+
+bool StressSearch::play(const Layout& layout, Scored& scored)
+{
+    string candidate = folder + "/.candidate.txt";
+    if (!write(layout, candidate)) {
+        return false;
+    }
+    if (world) {
+        world->reset(candidate);
+    } else {
+        world = new World(false, "MyAI", candidate);
+    }
+    auto start = chrono::steady_clock::now();
+    world->run();
+    scored.ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    scored.nodes = world->searchNodes();
+    scored.cost = options.byTime ? scored.ms : (double) scored.nodes;
+    scored.peakFrontier = world->peakFrontier();
+    scored.layout = layout;
+    return true;
+}
+
+void StressSearch::remember(const Scored& scored)
+{
+    if ((int) worst.size() >= options.keep && !scored.costlierThan(worst.back())) {
+        return;
+    }
+    for (const Scored& seen : worst) {
+        if (seen.layout.mines == scored.layout.mines && seen.layout.startX == scored.layout.startX
+            && seen.layout.startY == scored.layout.startY) {
+            return;
+        }
+    }
+    worst.push_back(scored);
+    sort(worst.begin(), worst.end(), [](const Scored& a, const Scored& b) { return a.costlierThan(b); });
+    if ((int) worst.size() > options.keep) {
+        worst.pop_back();
+    }
+}
+
+bool StressSearch::run(ostream& out)
+{
+    mkdir(folder.c_str(), 0755);
+    const char* unit = options.byTime ? " ms" : " nodes";
+
+    Layout layout, candidate;
+    Scored current, scored;
+    int stale = 0, restarts = 0;
+    for (int i = 0; i < options.iterations; ++i) {
+        bool restart = i == 0 || stale >= STRESS_PATIENCE;
+        if (restart) {
+            randomLayout(candidate);
+            stale = 0;
+            restarts += i > 0;
+        } else {
+            mutate(layout, candidate);
+        }
+        if (!play(candidate, scored)) {
+            out << "[ERROR] Failed to write to " << folder << "." << endl;
+            return false;
+        }
+        remember(scored);
+
+        if (restart || scored.costlierThan(current) || scored.sameCost(current)) {
+            if (!restart && scored.costlierThan(current)) {
+                out << "step " << setw(6) << i + 1 << ": " << fixed << setprecision(options.byTime ? 1 : 0)
+                    << scored.cost << unit << ", peak frontier " << scored.peakFrontier
+                    << " (worst " << worst.front().cost << unit << ")" << endl;
+                stale = 0;
+            } else {
+                ++stale;
+            }
+            current = scored;
+            layout = candidate;
+        } else {
+            ++stale;
+        }
+    }
+    remove((folder + "/.candidate.txt").c_str());
+
+    ofstream index(folder + "/.stress.tsv");
+    index << "# world\tnodes\tms\tpeak_frontier\n";
+    for (size_t n = 0; n < worst.size(); ++n) {
+        string name = "Stress_world_" + to_string(n + 1) + ".txt";
+        if (!write(worst[n].layout, folder + "/" + name)) {
+            out << "[ERROR] Failed to write " << name << "." << endl;
+            return false;
+        }
+        index << name << "\t" << worst[n].nodes << "\t" << fixed << setprecision(3) << worst[n].ms
+              << "\t" << worst[n].peakFrontier << "\n";
+    }
+    out << "Played " << options.iterations << " candidates (" << restarts << " restarts); wrote "
+        << worst.size() << " worlds to " << folder << endl;
+    return (bool) index;
+}
+
+}
+
+bool searchStressWorlds(const string& folder, const StressOptions& options, ostream& out)
+{
+    if (options.rows < 4 || options.cols < 4 || options.mines < 1 || options.mines > options.rows * options.cols - 9
+        || options.iterations < 1 || options.keep < 1 || options.moves < 1) {
+        return false;
+    }
+    StressSearch search(folder, options);
+    return search.run(out);
+}
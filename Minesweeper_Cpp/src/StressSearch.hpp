@@ -0,0 +1,59 @@
+// ======================================================================
+// FILE:        StressSearch.hpp
+//
+// DESCRIPTION: This file contains the stress world search: a hill climb
+//              over mine layouts looking for the worlds that cost MyAI
+//              the most, written out as a corpus for benchmarking the
+//              slow tail rather than the average game.
+//
+// NOTES:       - Every candidate is played in full through World and
+//                MyAI. Its cost is the enumeration nodes MyAI visited
+//                (searchNodes(), deterministic) or the wall time of the
+//                game. Equal costs are ordered by the largest frontier
+//                MyAI met, so the climb still has a direction while the
+//                cheaper engines solve every candidate.
+//
+//              - A step moves a few mines of the current layout to other
+//                squares, never into the 3x3 patch around the start. The
+//                candidate replaces the current layout if it costs at
+//                least as much. After STRESS_PATIENCE steps without an
+//                improvement, the climb restarts from a random layout.
+//
+//              - The costliest distinct layouts seen are written to the
+//                output folder as Stress_world_<n>.txt, in the world file
+//                format WorldGenerator.py writes, with .stress.tsv listing
+//                the nodes, time and peak frontier of each (a dot file,
+//                so running the folder with -f skips it).
+//
+//              - A candidate can take as long as MyAI's own time limits
+//                allow; the search is only as fast as its worst world.
+// ======================================================================
+
+#ifndef MINE_SWEEPER_CPP_SHELL_STRESSSEARCH_HPP
+#define MINE_SWEEPER_CPP_SHELL_STRESSSEARCH_HPP
+
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+// Steps without an improvement before the climb restarts
+#define STRESS_PATIENCE 50
+
+struct StressOptions {
+    int rows = 16;
+    int cols = 30;
+    int mines = 99;
+    int iterations = 200;       // candidates played, including restarts
+    int keep = 10;              // worlds written
+    int moves = 2;              // most mines moved per step
+    bool byTime = false;        // cost is wall time instead of search nodes
+    unsigned seed = 0;
+};
+
+// Runs the search and writes the corpus to 'folder', creating it if
+// needed. Returns false if the options are invalid or the folder can't be
+// written.
+bool searchStressWorlds ( const string& folder, const StressOptions& options, ostream& out );
+
+#endif //MINE_SWEEPER_CPP_SHELL_STRESSSEARCH_HPP
@@ -0,0 +1,248 @@
+// ======================================================================
+// FILE:        Sweep.cpp
+//
+// DESCRIPTION: This file contains the frontier sweep. See Sweep.hpp.
+// ======================================================================
+
+#include "Sweep.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+
+namespace {
+
+// Mines received so far by each open number, 4 bits per slot
+struct SweepKey {
+    uint64_t word[2] = {0, 0};
+
+    int get(int slot) const { return (word[slot >> 4] >> ((slot & 15) * 4)) & 15; }
+    void set(int slot, int count) { word[slot >> 4] |= (uint64_t) count << ((slot & 15) * 4); }
+    bool operator==(const SweepKey& other) const
+    {
+        return word[0] == other.word[0] && word[1] == other.word[1];
+    }
+};
+
+struct SweepKeyHash {
+    size_t operator()(const SweepKey& key) const
+    {
+        return (key.word[0] ^ key.word[1] * 0x9E3779B97F4A7C15ULL) * 0xFF51AFD7ED558CCDULL >> 17;
+    }
+};
+
+// A number touching the square being swept: where its count comes from
+// and goes to, and how many mines it can still take afterwards
+struct SweepCheck {
+    int source;     // slot before the square, -1 if it opens here
+    int target;     // slot after the square, -1 if it closes here
+    int mines;
+    int room;       // squares after this one plus slack
+};
+
+// Breadth-first search over the squares sharing a number, neighbors by
+// increasing degree, appending to order. Returns the last square reached.
+int bandSearch(const vector<vector<int>>& adjacent, int start, vector<char>& placed, vector<int>& order)
+{
+    size_t head = order.size();
+    order.push_back(start);
+    placed[start] = true;
+    while (head < order.size()) {
+        int cell = order[head++];
+        for (int other : adjacent[cell]) {
+            if (!placed[other]) {
+                placed[other] = true;
+                order.push_back(other);
+            }
+        }
+    }
+    return order.back();
+}
+
+// Orders the squares along the band: Cuthill-McKee from a far end, found
+// by searching twice for the square farthest away
+void bandOrder(const FrontierComponent& comp, vector<int>& order)
+{
+    size_t n = comp.cells.size();
+    vector<vector<int>> adjacent(n);
+    for (const Constraint& constraint : comp.constraints) {
+        for (int a : constraint.cells) {
+            for (int b : constraint.cells) {
+                if (a != b) {
+                    adjacent[a].push_back(b);
+                }
+            }
+        }
+    }
+    for (vector<int>& list : adjacent) {
+        sort(list.begin(), list.end());
+        list.erase(unique(list.begin(), list.end()), list.end());
+    }
+    for (vector<int>& list : adjacent) {
+        stable_sort(list.begin(), list.end(),
+            [&](int a, int b) { return adjacent[a].size() < adjacent[b].size(); });
+    }
+
+    vector<char> placed(n);
+    order.clear();
+    for (size_t seed = 0; seed < n; ++seed) {
+        if (placed[seed]) {
+            continue;
+        }
+        size_t from = order.size();
+        int end = (int) seed;
+        for (int round = 0; round < 2; ++round) {
+            end = bandSearch(adjacent, end, placed, order);
+            for (size_t k = from; k < order.size(); ++k) {
+                placed[order[k]] = false;
+            }
+            order.resize(from);
+        }
+        bandSearch(adjacent, end, placed, order);
+    }
+}
+
+}
+
+bool sweepComponent(const FrontierComponent& comp, ComponentSolution& solution)
+{
+    size_t n = comp.cells.size();
+    solution.mine_counts.assign(n, 0);
+    solution.total = 0;
+    for (const Constraint& constraint : comp.constraints) {
+        if (constraint.mines < 0 || constraint.mines > (int) constraint.cells.size() + constraint.slack) {
+            return true;
+        }
+    }
+
+    vector<int> order;
+    bandOrder(comp, order);
+    vector<int> rank(n);
+    for (size_t t = 0; t < n; ++t) {
+        rank[order[t]] = t;
+    }
+
+    // each number opens at its first square in the order and closes at its last
+    size_t m = comp.constraints.size();
+    vector<int> last(m, -1), seen(m, 0);
+    vector<vector<int>> cell_constraints(n);
+    for (size_t k = 0; k < m; ++k) {
+        for (int cell : comp.constraints[k].cells) {
+            last[k] = max(last[k], rank[cell]);
+            cell_constraints[cell].push_back(k);
+        }
+    }
+
+    vector<int> open, next_open;                // numbers in each slot
+    vector<int> slot(m, -1);                    // slot of each open number
+    vector<int> source;                         // slot each new slot copies
+    vector<SweepCheck> checks;
+
+    vector<vector<double>> forward(n + 1);
+    vector<vector<int>> next(n);                // [2 * state + mine] -> state
+    vector<SweepKey> keys(1), next_keys;
+    unordered_map<SweepKey, int, SweepKeyHash> index;
+    forward[0].assign(1, 1);
+
+    for (size_t t = 0; t < n; ++t) {
+        int cell = order[t];
+
+        // the open numbers after this square, and where their counts come from
+        next_open.clear();
+        source.clear();
+        for (size_t j = 0; j < open.size(); ++j) {
+            if (last[open[j]] != (int) t) {
+                next_open.push_back(open[j]);
+                source.push_back(j);
+            }
+        }
+        for (int k : cell_constraints[cell]) {
+            if (slot[k] < 0 && last[k] != (int) t) {
+                next_open.push_back(k);
+                source.push_back(-1);
+            }
+        }
+        if (next_open.size() > SWEEP_MAX_OPEN) {
+            return false;
+        }
+
+        checks.clear();
+        for (int k : cell_constraints[cell]) {
+            const Constraint& constraint = comp.constraints[k];
+            int room = constraint.cells.size() - ++seen[k] + constraint.slack;
+            checks.push_back({slot[k], -1, constraint.mines, room});
+        }
+        for (int k : open) {
+            slot[k] = -1;
+        }
+        for (size_t j = 0; j < next_open.size(); ++j) {
+            slot[next_open[j]] = j;
+        }
+        for (size_t i = 0; i < checks.size(); ++i) {
+            checks[i].target = slot[cell_constraints[cell][i]];
+        }
+
+        double odds = comp.mine_odds.empty() ? 1 : comp.mine_odds[cell];
+        next_keys.clear();
+        index.clear();
+        next[t].assign(2 * keys.size(), -1);
+        vector<double>& from = forward[t];
+        vector<double>& to = forward[t + 1];
+        for (size_t s = 0; s < keys.size(); ++s) {
+            for (int mine = 0; mine <= 1; ++mine) {
+                SweepKey key;
+                for (size_t j = 0; j < source.size(); ++j) {
+                    if (source[j] >= 0) {
+                        key.set(j, keys[s].get(source[j]));
+                    }
+                }
+                bool ok = true;
+                for (const SweepCheck& check : checks) {
+                    int count = (check.source >= 0 ? keys[s].get(check.source) : 0) + mine;
+                    if (count > check.mines || check.mines - count > check.room) {
+                        ok = false;
+                        break;
+                    }
+                    if (check.target >= 0) {
+                        key.word[check.target >> 4] &= ~((uint64_t) 15 << ((check.target & 15) * 4));
+                        key.set(check.target, count);
+                    }
+                }
+                if (!ok) {
+                    continue;
+                }
+                auto found = index.emplace(key, (int) next_keys.size());
+                if (found.second) {
+                    next_keys.push_back(key);
+                    to.push_back(0);
+                }
+                next[t][2 * s + mine] = found.first->second;
+                to[found.first->second] += from[s] * (mine ? odds : 1);
+            }
+        }
+        if (next_keys.size() > SWEEP_MAX_STATES) {
+            return false;
+        }
+        if (next_keys.empty()) {
+            return true;
+        }
+        keys.swap(next_keys);
+        open.swap(next_open);
+    }
+
+    // every number is closed by now, so the last layer is the one empty state
+    solution.total = forward[n][0];
+    vector<double> backward(1, 1), earlier;
+    for (size_t t = n; t-- > 0;) {
+        int cell = order[t];
+        double odds = comp.mine_odds.empty() ? 1 : comp.mine_odds[cell];
+        earlier.assign(forward[t].size(), 0);
+        for (size_t s = 0; s < earlier.size(); ++s) {
+            int safe = next[t][2 * s], mine = next[t][2 * s + 1];
+            double with_mine = mine >= 0 ? odds * backward[mine] : 0;
+            solution.mine_counts[cell] += forward[t][s] * with_mine;
+            earlier[s] = (safe >= 0 ? backward[safe] : 0) + with_mine;
+        }
+        backward.swap(earlier);
+    }
+    return true;
+}
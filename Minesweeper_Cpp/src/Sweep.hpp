@@ -0,0 +1,49 @@
+// ======================================================================
+// FILE:        Sweep.hpp
+//
+// DESCRIPTION: This file contains the frontier sweep: a dynamic program
+//              that solves a frontier component in time linear in its
+//              length, so long expert frontiers, far past what the
+//              backtracking of solveComponent can finish, are solved
+//              exactly.
+//
+// NOTES:       - The frontier is a band a square or two wide. Its squares
+//                are put in band order (a Cuthill-McKee order of the
+//                squares sharing a number, started from a far end), and
+//                swept in that order. At any point only the numbers with
+//                squares on both sides of the sweep are open, and only
+//                how many mines each has received so far matters for the
+//                rest of the sweep. That is the state: a handful of small
+//                counts, so a layer holds a few dozen states however
+//                long the band is.
+//
+//              - A forward pass counts the (weighted) assignments that
+//                reach each state, and a backward pass the ways each
+//                state completes; a square's mine count is the sum over
+//                the states before it of forward times backward through
+//                its mine transition. The results are the same as
+//                solveComponent's, mine_odds included.
+//
+//              - A component whose band is too thick (more than
+//                SWEEP_MAX_OPEN open numbers, or more than
+//                SWEEP_MAX_STATES states in a layer) is refused; the
+//                caller falls back to the engines it used before.
+// ======================================================================
+
+#ifndef MINE_SWEEPER_CPP_SHELL_SWEEP_HPP
+#define MINE_SWEEPER_CPP_SHELL_SWEEP_HPP
+
+#include "Frontier.hpp"
+
+// Most numbers open at once across the sweep (4 bits of state each)
+#define SWEEP_MAX_OPEN 32
+
+// Most states in one layer of the sweep
+#define SWEEP_MAX_STATES (1 << 16)
+
+// Solves a component like solveComponent. Returns false if the component
+// is too thick to sweep; otherwise solution.total is 0 if it has no
+// solution.
+bool sweepComponent(const FrontierComponent& comp, ComponentSolution& solution);
+
+#endif //MINE_SWEEPER_CPP_SHELL_SWEEP_HPP
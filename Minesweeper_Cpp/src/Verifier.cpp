@@ -0,0 +1,457 @@
+// ======================================================================
+// FILE:        Verifier.cpp
+//
+// DESCRIPTION: This file contains the solver verifier and the replay of
+//              dumped positions. See Verifier.hpp.
+// ======================================================================
+
+#include "Verifier.hpp"
+#include "BitSlice.hpp"
+#include "MyAI.hpp"
+#include "Sweep.hpp"
+#include <cmath>
+#include <sstream>
+
+// Two probabilities closer than this are the same
+#define VERIFY_EPSILON 1e-9
+
+SolverVerifier& SolverVerifier::shared()
+{
+    static SolverVerifier verifier;
+    return verifier;
+}
+
+bool SolverVerifier::open(const string& dumpFile)
+{
+    dump_file.open(dumpFile, ios::app);
+    return (bool) dump_file;
+}
+
+void SolverVerifier::reference(BoardRep& board)
+{
+    findFrontier(board);
+    ref_prob.assign(ref_cells.size(), -1);
+    ref_safe = 0;
+    ref_mines = 0;
+    ref_min = 2;
+
+    // split into components through shared numbered squares, solving each
+    // as soon as it is complete
+    comp_seen.setup(board.rowSize, board.colSize, board.large);
+    comp_numbers.setup(board.rowSize, board.colSize, board.large);
+    vector<int> cells;
+    for (size_t i = 0; i < ref_cells.size(); ++i) {
+        if (!comp_seen.insert(ref_cells[i])) {
+            continue;
+        }
+        cells.assign(1, (int) i);
+        for (size_t next = 0; next < cells.size(); ++next) {
+            Coord cell = ref_cells[cells[next]];
+            for (int dx = -1; dx <= 1; ++dx) {
+                for (int dy = -1; dy <= 1; ++dy) {
+                    Coord number(cell.x + dx, cell.y + dy);
+                    if (board.getSquare(number.x, number.y) < 0) {
+                        continue;
+                    }
+                    for (int ex = -1; ex <= 1; ++ex) {
+                        for (int ey = -1; ey <= 1; ++ey) {
+                            Coord other(number.x + ex, number.y + ey);
+                            if (board.withinBounds(other.x, other.y) && ref_cells.count(other) && comp_seen.insert(other)) {
+                                cells.push_back(ref_cells.position(other));
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        solveComponent(board, cells);
+    }
+    ready = true;
+}
+
+// Covered squares next to a numbered square, found from the board itself
+// rather than from BoardRep::frontier_covered (except on large boards,
+// where a full scan per check would be too slow)
+void SolverVerifier::findFrontier(BoardRep& board)
+{
+    ref_cells.setup(board.rowSize, board.colSize, board.large);
+
+    auto bordersNumber = [&board](int x, int y) {
+        for (int dx = -1; dx <= 1; ++dx) {
+            for (int dy = -1; dy <= 1; ++dy) {
+                if ((dx || dy) && board.getSquare(x + dx, y + dy) >= 0) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    };
+
+    if (board.large) {
+        for (const Coord& c : board.frontier_covered) {
+            if (board.getSquare(c.x, c.y) == COVERED && bordersNumber(c.x, c.y)) {
+                ref_cells.insert(c);
+            }
+        }
+        return;
+    }
+    for (int y = 0; y < board.rowSize; ++y) {
+        for (int x = 0; x < board.colSize; ++x) {
+            if (board.getSquare(x, y) == COVERED && bordersNumber(x, y)) {
+                ref_cells.insert(Coord(x, y));
+            }
+        }
+    }
+}
+
+void SolverVerifier::solveComponent(BoardRep& board, const vector<int>& cells)
+{
+    size_t n = cells.size();
+    if (n > VERIFY_MAX_COMPONENT) {
+        return;
+    }
+
+    comp_cells = cells;
+    comp_constraints.clear();
+    cell_constraints.assign(n, vector<int>());
+    comp_numbers.clear();
+    for (size_t i = 0; i < n; ++i) {
+        Coord cell = ref_cells[cells[i]];
+        for (int dx = -1; dx <= 1; ++dx) {
+            for (int dy = -1; dy <= 1; ++dy) {
+                Coord number(cell.x + dx, cell.y + dy);
+                int value = board.getSquare(number.x, number.y);
+                if (value < 0 || !comp_numbers.insert(number)) {
+                    continue;
+                }
+                RefConstraint constraint = {value, 0};
+                int k = (int) comp_constraints.size();
+                for (int ex = -1; ex <= 1; ++ex) {
+                    for (int ey = -1; ey <= 1; ++ey) {
+                        Coord other(number.x + ex, number.y + ey);
+                        Square square = board.getSquare(other.x, other.y);
+                        if (square == FLAGGED) {
+                            --constraint.need;
+                        } else if (square == COVERED) {
+                            ++constraint.open;
+                            // every covered neighbor is in this component
+                            int local = find(cells.begin(), cells.end(), ref_cells.position(other)) - cells.begin();
+                            cell_constraints[local].push_back(k);
+                        }
+                    }
+                }
+                comp_constraints.push_back(constraint);
+            }
+        }
+    }
+
+    for (const RefConstraint& c : comp_constraints) {
+        if (c.need < 0 || c.need > c.open) {
+            return;  // no assignment can satisfy it; leave the squares unknown
+        }
+    }
+
+    assignment.assign(n, 0);
+    comp_counts.assign(n, 0);
+    comp_total = 0;
+    nodes = 0;
+    search(0);
+    if (nodes > VERIFY_NODE_BUDGET || comp_total == 0) {
+        return;
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        double p = comp_counts[i] / comp_total;
+        ref_prob[cells[i]] = p;
+        if (p == 0) {
+            ++ref_safe;
+        } else if (p == 1) {
+            ++ref_mines;
+        }
+        ref_min = min(ref_min, p);
+    }
+}
+
+// Plain depth-first enumeration: each square is tried as safe and as a
+// mine, and a branch is cut as soon as a constraint can't be met
+void SolverVerifier::search(size_t depth)
+{
+    if (++nodes > VERIFY_NODE_BUDGET) {
+        return;
+    }
+    if (depth == comp_cells.size()) {
+        comp_total += 1;
+        for (size_t i = 0; i < depth; ++i) {
+            comp_counts[i] += assignment[i];
+        }
+        return;
+    }
+
+    const vector<int>& constraints = cell_constraints[depth];
+    for (int value = 0; value <= 1; ++value) {
+        bool ok = true;
+        for (int k : constraints) {
+            RefConstraint& c = comp_constraints[k];
+            --c.open;
+            c.need -= value;
+            ok = ok && c.need >= 0 && c.need <= c.open;
+        }
+        if (ok) {
+            assignment[depth] = value;
+            search(depth + 1);
+        }
+        for (int k : constraints) {
+            ++comp_constraints[k].open;
+            comp_constraints[k].need += value;
+        }
+    }
+}
+
+double SolverVerifier::probability(const Coord& c) const
+{
+    int index = ref_cells.position(c);
+    return index < 0 ? -1 : ref_prob[index];
+}
+
+bool SolverVerifier::check(const string& engine, bool complete, BoardRep& board, const CoordQueue& queued)
+{
+    if (!ready) {
+        return true;
+    }
+    ++checks;
+    ostringstream problem;
+
+    // every square the engine flagged must always be a mine
+    int flagged = 0;
+    for (size_t i = 0; i < ref_cells.size(); ++i) {
+        const Coord& c = ref_cells[i];
+        if (board.getSquare(c.x, c.y) != FLAGGED) {
+            continue;
+        }
+        ++flagged;
+        if (ref_prob[i] >= 0 && ref_prob[i] < 1) {
+            problem << "flagged " << c.toString() << " with mine probability " << ref_prob[i] << "; ";
+        }
+    }
+
+    // every square it queued must always be safe, unless it is a lone guess
+    int unsafe = 0;
+    Coord guess;
+    double guess_prob = -1;
+    for (const Coord& c : queued) {
+        double p = probability(c);
+        if (p > 0) {
+            ++unsafe;
+            guess = c;
+            guess_prob = p;
+        }
+    }
+    if (unsafe && queued.size() > 1) {
+        problem << "queued " << guess.toString() << " as safe with mine probability " << guess_prob << "; ";
+    } else if (unsafe && complete) {
+        if (ref_safe) {
+            problem << "guessed " << guess.toString() << " with " << ref_safe << " safe squares left; ";
+        } else if (guess_prob > ref_min + VERIFY_EPSILON) {
+            problem << "guessed " << guess.toString() << " at " << guess_prob << " over a square at " << ref_min << "; ";
+        }
+    }
+
+    // a complete engine must find what there is to find
+    if (complete && queued.empty() && !flagged && (ref_safe || ref_mines)) {
+        problem << "missed " << ref_safe << " safe squares and " << ref_mines << " mines; ";
+    }
+
+    if (ref_min > 1 && !ref_safe && !ref_mines) {
+        ++skipped;  // nothing solved, so nothing was really checked
+    }
+    return report(engine, board, problem.str());
+}
+
+namespace {
+
+// Counts the same up to rounding
+bool sameCount(double a, double b)
+{
+    return fabs(a - b) <= VERIFY_EPSILON * max(1.0, fabs(b));
+}
+
+// Describes where 'found' differs from the backtracking's 'expected'
+void compareSolutions(const char* engine, const FrontierComponent& comp, const ComponentSolution& expected,
+                      const ComponentSolution& found, ostream& problem)
+{
+    if (!sameCount(found.total, expected.total)) {
+        problem << engine << " found " << found.total << " solutions of the " << comp.cells.size()
+                << "-square component at " << comp.cells[0].toString() << ", backtracking " << expected.total << "; ";
+        return;
+    }
+    for (size_t i = 0; i < comp.cells.size(); ++i) {
+        if (!sameCount(found.mine_counts[i], expected.mine_counts[i])) {
+            problem << engine << " put a mine on " << comp.cells[i].toString() << " in " << found.mine_counts[i]
+                    << " solutions, backtracking in " << expected.mine_counts[i] << "; ";
+            return;
+        }
+    }
+}
+
+}
+
+bool SolverVerifier::checkSolver(const string& engine, BoardRep& board, const vector<FrontierComponent>& components)
+{
+    ++checks;
+    ostringstream problem;
+    ComponentSolution expected, found;
+    for (const FrontierComponent& comp : components) {
+        if (comp.cells.size() > COMPONENT_SOLVE_LIMIT || !componentFeasible(comp)) {
+            continue;
+        }
+        backtrackComponent(comp, expected);
+        if (engine == "sweep") {
+            if (sweepComponent(comp, found)) {
+                compareSolutions("sweep", comp, expected, found, problem);
+            }
+        } else if (engine == "bitslice" && comp.cells.size() <= BITSLICE_MAX_CELLS && comp.mine_odds.empty()) {
+            bitSliceCount(comp, found, false);
+            compareSolutions("64-lane kernel", comp, expected, found, problem);
+            if (bitSliceWide()) {
+                bitSliceCount(comp, found, true);
+                compareSolutions("256-lane kernel", comp, expected, found, problem);
+            }
+        }
+    }
+    return report(engine, board, problem.str());
+}
+
+bool SolverVerifier::report(const string& engine, BoardRep& board, const string& problem)
+{
+    last_problem = problem;
+    if (last_problem.empty()) {
+        return true;
+    }
+    ++mismatches;
+    dump(engine, board, last_problem);
+    return false;
+}
+
+void SolverVerifier::dump(const string& engine, BoardRep& board, const string& problem)
+{
+    if (!dump_file.is_open()) {
+        return;
+    }
+    dump_file << "position " << board.rowSize << " " << board.colSize << " " << board.totalMines << " " << engine << "\n";
+    dump_file << "# " << problem << "\n";
+    for (int y = board.rowSize - 1; y >= 0; --y) {
+        for (int x = 0; x < board.colSize; ++x) {
+            Square square = board.getSquare(x, y);
+            dump_file << (square == FLAGGED ? 'F' : square >= 0 ? (char) ('0' + square) : '.');
+        }
+        dump_file << "\n";
+    }
+    dump_file.flush();
+}
+
+// ===============================================================
+// =                    Position replay
+// ===============================================================
+
+namespace {
+
+// Runs one engine the way MyAI::next_action does. Returns false for an
+// unknown engine name.
+bool runEngine(MyAI& agent, const string& engine, bool& complete)
+{
+    complete = false;
+    if (engine == "pattern") {
+        agent.patternStrategy();
+    } else if (engine == "component") {
+        agent.componentStrategy();
+    } else if (engine == "regions") {
+        agent.enumerateFrontierRegions();
+    } else if (engine == "exact") {
+        complete = true;
+        agent.enumerateFrontierStrategy();
+    } else if (engine == "sloppy") {
+        complete = agent.boardObj->frontier_covered.size() <= SLOPPY_MAX_FACTORS;
+        agent.enumerateFrontierStrategy_Sloppy();
+    } else {
+        return false;
+    }
+    return true;
+}
+
+}
+
+bool replayPositions(const string& filename, ostream& out)
+{
+    ifstream file(filename);
+    if (!file) {
+        return false;
+    }
+
+    SolverVerifier& verifier = SolverVerifier::shared();
+    bool was_enabled = verifier.enabled;
+    verifier.enabled = true;
+
+    string line;
+    int index = 0, still = 0;
+    while (getline(file, line)) {
+        istringstream header(line);
+        string word, engine;
+        int rows, cols, mines;
+        if (!(header >> word >> rows >> cols >> mines >> engine) || word != "position") {
+            continue;
+        }
+        ++index;
+
+        MyAI agent(rows, cols, mines, 0, 0);
+        BoardRep& board = *agent.boardObj;
+        for (int y = rows - 1; y >= 0; --y) {
+            do {
+                getline(file, line);
+            } while (file && !line.empty() && line[0] == '#');
+            for (int x = 0; x < cols && x < (int) line.size(); ++x) {
+                if (line[x] == 'F') {
+                    board.updateSquare(x, y, FLAGGED);
+                    board.all_covered.erase(Coord(x, y));
+                } else if ('0' <= line[x] && line[x] <= '8') {
+                    board.updateSquare(x, y, line[x] - '0');
+                }
+            }
+        }
+        for (int y = 0; y < rows; ++y) {
+            for (int x = 0; x < cols; ++x) {
+                if (board.getSquare(x, y) != COVERED) {
+                    continue;
+                }
+                NeighborBuf numbered;
+                agent.get_neighbors(Coord(x, y), NUMBERED, numbered);
+                if (numbered.size()) {
+                    board.frontier_covered.insert(Coord(x, y));
+                }
+            }
+        }
+
+        bool complete, ok;
+        verifier.reference(board);
+        if (engine == "sweep" || engine == "bitslice") {
+            FrontierRegions regions;
+            regions.setup(rows, cols, board.large);
+            regions.split(board, board.frontier_covered.size());
+            ok = verifier.checkSolver(engine, board, regions.components);
+        } else if (runEngine(agent, engine, complete)) {
+            ok = verifier.check(engine, complete, board, agent.toUncoverVector);
+        } else {
+            out << "position " << index << ": unknown engine " << engine << endl;
+            continue;
+        }
+        if (ok) {
+            out << "position " << index << " (" << engine << "): ok" << endl;
+        } else {
+            out << "position " << index << " (" << engine << "): " << verifier.last_problem << endl;
+            ++still;
+        }
+    }
+
+    verifier.enabled = was_enabled;
+    out << still << " of " << index << " positions still mismatch" << endl;
+    return true;
+}
@@ -0,0 +1,124 @@
+// ======================================================================
+// FILE:        Verifier.hpp
+//
+// DESCRIPTION: This file contains the solver verifier: a reference
+//              exhaustive enumeration of the frontier that is run next to
+//              MyAI's engines (pattern, component, exact, sloppy and
+//              regions) to check what each of them concludes.
+//
+// NOTES:       - The reference shares no code with the engines. It finds
+//                the frontier, splits it into components and enumerates
+//                every assignment of each component on its own, giving
+//                every frontier square its exact mine probability (over
+//                consistent assignments, without the global mine count,
+//                like the engines).
+//
+//              - After an engine runs, every square it queued to uncover
+//                must be safe and every square it flagged must be a mine.
+//                A single unsafe square queued alone is taken as a guess.
+//                Complete engines (exact, and sloppy while the frontier
+//                fits its limit) must also find something when there is
+//                something to find, and guess a square of the lowest
+//                probability.
+//
+//              - The faster component engines are checked apart from the
+//                moves: checkSolver() solves every component of up to
+//                COMPONENT_SOLVE_LIMIT squares with one of them ("sweep",
+//                the frontier sweep, or "bitslice", both bit-sliced
+//                kernels on components of up to BITSLICE_MAX_CELLS
+//                squares) and with solveComponent's backtracking, and the
+//                counts must agree square by square.
+//
+//              - Components over VERIFY_MAX_COMPONENT squares, or that
+//                take more than VERIFY_NODE_BUDGET search steps, are not
+//                checked.
+//
+//              - A mismatch appends the agent's view of the board to the
+//                dump file. replayPositions() loads such a file and runs
+//                the named engine on every position again, so a fix can
+//                be checked without the game that found the problem.
+//                Position file:
+//
+//                  position <rows> <cols> <mines> <engine>
+//                  # <what went wrong>
+//                  <rows lines, top row first: '.' covered, 'F' flagged, 0-8>
+// ======================================================================
+
+#ifndef MINE_SWEEPER_CPP_SHELL_VERIFIER_HPP
+#define MINE_SWEEPER_CPP_SHELL_VERIFIER_HPP
+
+#include "BoardRep.hpp"
+#include "Frontier.hpp"
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#define VERIFY_MAX_COMPONENT 48
+#define VERIFY_NODE_BUDGET 20000000LL
+
+class SolverVerifier
+{
+public:
+    // The verifier MyAI reports to; off unless Main enables it
+    static SolverVerifier& shared();
+
+    bool enabled = false;
+    bool open ( const string& dumpFile );  // mismatching positions are appended here
+
+    // Solves the current frontier; called before the engines run
+    void reference ( BoardRep& board );
+
+    // Checks what 'engine' did to the board and queued since reference().
+    // Returns false on a mismatch.
+    bool check ( const string& engine, bool complete, BoardRep& board, const CoordQueue& queued );
+
+    // Solves the board's components with component engine 'engine' and by
+    // backtracking. Returns false if the counts differ.
+    bool checkSolver ( const string& engine, BoardRep& board, const vector<FrontierComponent>& components );
+
+    // Statistics
+    long long checks = 0;
+    long long mismatches = 0;
+    long long skipped = 0;   // checks without a usable reference
+    string last_problem;
+
+private:
+    void findFrontier ( BoardRep& board );
+    void solveComponent ( BoardRep& board, const vector<int>& cells );
+    void search ( size_t depth );
+    void dump ( const string& engine, BoardRep& board, const string& problem );
+    bool report ( const string& engine, BoardRep& board, const string& problem );
+    double probability ( const Coord& c ) const;
+
+    std::ofstream dump_file;
+
+    // reference solution of the current frontier
+    bool ready = false;
+    CoordSet ref_cells;             // frontier squares, by index
+    vector<double> ref_prob;        // mine probability per index, or -1 if unknown
+    int ref_safe = 0;               // squares that are always safe
+    int ref_mines = 0;              // squares that are always mines
+    double ref_min = 2;             // lowest probability of an unknown square
+
+    // component search state
+    struct RefConstraint {
+        int need;                   // mines still to place
+        int open;                   // squares not yet assigned
+    };
+    vector<int> comp_cells;         // indexes into ref_cells, search order
+    vector<RefConstraint> comp_constraints;
+    vector<vector<int>> cell_constraints;   // constraints of each comp_cells entry
+    vector<char> assignment;
+    vector<double> comp_counts;
+    double comp_total = 0;
+    long long nodes = 0;
+    CoordSet comp_seen;
+    CoordSet comp_numbers;
+};
+
+// Runs the engine named in each position of a dump file again, with the
+// verifier on, and prints whether it still mismatches. Returns false if
+// the file can't be read.
+bool replayPositions ( const string& filename, ostream& out );
+
+#endif //MINE_SWEEPER_CPP_SHELL_VERIFIER_HPP
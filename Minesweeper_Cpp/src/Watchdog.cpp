@@ -0,0 +1,123 @@
+// ======================================================================
+// FILE:        Watchdog.cpp
+//
+// DESCRIPTION: This file contains the watchdog. See Watchdog.hpp.
+// ======================================================================
+
+#include "Watchdog.hpp"
+#include <algorithm>
+#include <iostream>
+#include <unistd.h>
+
+atomic<bool> Watchdog::cancel{false};
+
+Watchdog& Watchdog::shared()
+{
+    static Watchdog watchdog;
+    return watchdog;
+}
+
+Watchdog::~Watchdog()
+{
+    stop();
+}
+
+void Watchdog::start(int _moveMs, int _gameMs, int _graceMs)
+{
+    stop();
+    moveMs = max(_moveMs, 0);
+    gameMs = max(_gameMs, 0);
+    graceMs = max(_graceMs, 0);
+    enabled = moveMs > 0 || gameMs > 0;
+    if (enabled) {
+        stopping = false;
+        monitor = thread(&Watchdog::watch, this);
+    }
+}
+
+void Watchdog::stop()
+{
+    if (monitor.joinable()) {
+        {
+            lock_guard<mutex> guard(lock);
+            stopping = true;
+        }
+        wake.notify_all();
+        monitor.join();
+    }
+    enabled = false;
+}
+
+void Watchdog::beginGame()
+{
+    if (!enabled) {
+        return;
+    }
+    reason.store(TIMEOUT_NONE, memory_order_relaxed);
+    cancel.store(false, memory_order_relaxed);
+    gameStart.store(chrono::steady_clock::now().time_since_epoch().count(), memory_order_relaxed);
+    playing.store(enabled, memory_order_relaxed);
+}
+
+void Watchdog::watch()
+{
+    int shortest = moveMs && gameMs ? min(moveMs, gameMs) : max(moveMs, gameMs);
+    chrono::milliseconds tick(min(max(shortest / 10, 1), 100));
+    chrono::milliseconds moveLimit(moveMs), gameLimit(gameMs), grace(graceMs);
+
+    unsigned seenTurn = turns.load(memory_order_relaxed);
+    auto seenAt = chrono::steady_clock::now();
+    unsigned cancelledTurn = 0;
+    auto cancelledAt = seenAt;
+
+    unique_lock<mutex> guard(lock);
+    while (!stopping) {
+        wake.wait_for(guard, tick);
+        auto now = chrono::steady_clock::now();
+        unsigned turn = turns.load(memory_order_relaxed);
+        if (turn != seenTurn) {
+            // a turn started since the last tick; time it from here
+            seenTurn = turn;
+            seenAt = now;
+        }
+        bool busy = inTurn.load(memory_order_relaxed);
+
+        if (!cancelled() && playing.load(memory_order_relaxed)) {
+            auto started = chrono::steady_clock::time_point(
+                chrono::steady_clock::duration(gameStart.load(memory_order_relaxed)));
+            WatchdogTimeout why = TIMEOUT_NONE;
+            if (moveMs && busy && now - seenAt >= moveLimit) {
+                why = TIMEOUT_MOVE;
+            } else if (gameMs && now - started >= gameLimit) {
+                why = TIMEOUT_GAME;
+            }
+            if (why != TIMEOUT_NONE) {
+                expire(why);
+                cancelledTurn = turn;
+                cancelledAt = now;
+            }
+        } else if (cancelled() && busy && turn == cancelledTurn && now - cancelledAt >= grace) {
+            forfeit();
+        }
+    }
+}
+
+void Watchdog::expire(WatchdogTimeout why)
+{
+    reason.store(why, memory_order_relaxed);
+    cancel.store(true, memory_order_relaxed);
+    ++(why == TIMEOUT_MOVE ? moveTimeouts : gameTimeouts);
+}
+
+// The agent ignored the token: record the game and end the run, since
+// the thread running the agent can't be stopped from here
+void Watchdog::forfeit()
+{
+    WatchdogTimeout why = timedOut();
+    if (forfeitHook) {
+        forfeitHook(why);
+    }
+    cout << "[ERROR] The agent ignored a " << (why == TIMEOUT_MOVE ? "move" : "game")
+         << " timeout for " << graceMs << " ms; the game is forfeited and the run stopped." << endl;
+    _exit(WATCHDOG_EXIT_CODE);
+}
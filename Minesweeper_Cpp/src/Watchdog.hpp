@@ -0,0 +1,114 @@
+// ======================================================================
+// FILE:        Watchdog.hpp
+//
+// DESCRIPTION: This file contains the watchdog: wall-clock deadlines on
+//              every agent turn and every game, enforced by a monitoring
+//              thread, so one runaway search or a hung agent costs its
+//              own game instead of stalling the run.
+//
+// NOTES:       - Off unless Main enables it (--move-timeout, --game-timeout).
+//                World::run brackets the game with beginGame/endGame and
+//                every call into the agent with beginTurn/endTurn; a turn
+//                is one getAction or one batch of getActions.
+//
+//              - The monitor wakes every tick (a tenth of the shortest
+//                deadline, 1 to 100 ms). Once the turn in progress or the
+//                game passes its deadline, it sets the cancellation token.
+//                World stops the game at the end of that turn and scores
+//                it 0, and timedOut() tells the caller it was a timeout.
+//
+//              - Cancellation is cooperative: MyAI polls cancelled() in its
+//                enumeration and gives up the turn with a LEAVE. An agent
+//                that doesn't poll it (RandomAI, plugins, which keep their
+//                own copy of the watchdog, external agents) runs its turn
+//                to the end. If the turn is still running 'grace' ms
+//                after the token was set, the game is forfeited by force:
+//                the forfeit hook runs on the monitor thread (Main records
+//                the world as a timeout in the results log) and the
+//                process exits with WATCHDOG_EXIT_CODE, since a thread
+//                can't be stopped safely from outside. A run with
+//                --results picks up after that world with --resume.
+// ======================================================================
+
+#ifndef MINE_SWEEPER_CPP_SHELL_WATCHDOG_HPP
+#define MINE_SWEEPER_CPP_SHELL_WATCHDOG_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+// Exit status of a run stopped by a forced forfeit
+#define WATCHDOG_EXIT_CODE 3
+
+// Time a cancelled turn gets to return before the forced forfeit
+#define WATCHDOG_GRACE_MS 1000
+
+enum WatchdogTimeout {
+    TIMEOUT_NONE,
+    TIMEOUT_MOVE,
+    TIMEOUT_GAME
+};
+
+class Watchdog
+{
+public:
+    // The watchdog World reports to; off unless Main starts it
+    static Watchdog& shared();
+    ~Watchdog();
+
+    // Starts the monitor with these deadlines in ms (0: no deadline)
+    void start ( int moveMs, int gameMs, int graceMs = WATCHDOG_GRACE_MS );
+    void stop ();
+
+    // The cancellation token, polled by agents that can stop early
+    static bool cancelled () { return cancel.load( memory_order_relaxed ); }
+
+    void beginGame ();
+    void endGame () { playing.store( false, memory_order_relaxed ); }
+    void beginTurn () {
+        if ( enabled ) {
+            turns.store( turns.load( memory_order_relaxed ) + 1, memory_order_relaxed );
+            inTurn.store( true, memory_order_relaxed );
+        }
+    }
+    void endTurn () { inTurn.store( false, memory_order_relaxed ); }
+
+    // Why the current (or last) game was stopped
+    WatchdogTimeout timedOut () const { return reason.load( memory_order_relaxed ); }
+
+    // Runs on the monitor thread before a forced forfeit exits
+    function<void ( WatchdogTimeout )> forfeitHook;
+
+    bool enabled = false;
+    int moveMs = 0;
+    int gameMs = 0;
+    int graceMs = WATCHDOG_GRACE_MS;
+
+    // Statistics
+    atomic<long long> moveTimeouts{0};
+    atomic<long long> gameTimeouts{0};
+
+private:
+    void watch ();
+    void expire ( WatchdogTimeout why );
+    void forfeit ();
+
+    static atomic<bool> cancel;
+    atomic<unsigned> turns{0};
+    atomic<bool> inTurn{false};
+    atomic<bool> playing{false};
+    atomic<long long> gameStart{0};             // steady_clock ticks
+    atomic<WatchdogTimeout> reason{TIMEOUT_NONE};
+
+    thread monitor;
+    mutex lock;
+    condition_variable wake;
+    bool stopping = false;
+};
+
+#endif //MINE_SWEEPER_CPP_SHELL_WATCHDOG_HPP
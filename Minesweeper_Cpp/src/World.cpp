@@ -18,10 +18,55 @@ using namespace std;
 // =				Constructor and Destructor
 // ===============================================================
 
-World::World(bool _debug, string aiType, string filename)
+World::World(bool _debug, string aiType, string filename, WorldOptions _options)
+{
+    chooseAgent( _debug, aiType, _options );
+    reset( filename );
+}
+
+World::World(bool _debug, string aiType, const WorldLayout& layout, string name, WorldOptions _options)
+{
+    chooseAgent( _debug, aiType, _options );
+    reset( layout, name );
+}
+
+void World::chooseAgent(bool _debug, string aiType, WorldOptions _options)
 {
     // Operation Flags
-    debug = _debug;
+    options = _options;
+    debug = _debug || options.watch;
+
+    if (options.plugin)
+        agentKind = PLUGIN_AI;
+    else if (!options.agentCommand.empty())
+        agentKind = EXTERNAL_AI;
+    else if (aiType == "randomAI")
+        agentKind = RANDOM_AI;
+    else if (aiType == "manualAI")
+        agentKind = MANUAL_AI;
+    else
+        agentKind = MY_AI;
+}
+
+World::~World() {
+    if ( agentKind == PLUGIN_AI )
+        options.plugin->destroy( agent );
+    else
+        delete agent;
+    delete [] board;
+    delete [] tiles;
+}
+
+void World::reset( string filename )
+// Loads the next world into this object. Board and agent buffers are kept
+// when the dimensions match the previous world, so a batch run pays for a
+// clear of the existing memory instead of a fresh set of allocations.
+{
+    totalMines   = 0;
+    correctFlags = 0;
+    moveCount    = 0;
+    worldName    = filename;
+    revealed.clear();
 
     // World Initialization
     // True for file provided; false for file not provided, board with default size and random feature
@@ -32,29 +77,30 @@ World::World(bool _debug, string aiType, string filename)
         ifstream file;
         file.open(filename);
 
-        file >> rowDimension >> colDimension;
+        int rows, cols;
+        file >> rows >> cols;
 
         if (file.fail())
             throw exception();
-        board = new Tile*[colDimension];
-        for ( int index = 0; index < colDimension; ++index )
-            board[index] = new Tile[rowDimension];
-
+        allocateBoard( rows, cols );
 
         file >> agentX >> agentY;
-        lastAction = genFirstAxis(--agentX, --agentY);
+        --agentX;
+        --agentY;
         addFeatures ( file );
         file.close();
+        // checked once the mines and numbers are in place
+        lastAction = genFirstAxis(agentX, agentY);
 
     }
     else
     {
+        // reseeded from the run's sequence so a trace can name this board
+        worldSeed = rand();
+        srand( worldSeed );
+
         totalMines        = 10;
-        colDimension    = 8;
-        rowDimension    = 8;
-        board = new Tile*[colDimension];
-        for ( int index = 0; index < colDimension; ++index )
-            board[index] = new Tile[rowDimension];
+        allocateBoard( 8, 8 );
 
         lastAction   = genFirstAxis();
         agentX       = lastAction.x;
@@ -63,7 +109,39 @@ World::World(bool _debug, string aiType, string filename)
         addFeatures();
     }
 
-    maxMoves = rowDimension * colDimension * 2;
+    startGame();
+}
+
+void World::reset( const WorldLayout& layout, string name )
+// Loads a world read earlier, exactly as reset() would load its file
+{
+    totalMines   = 0;
+    correctFlags = 0;
+    moveCount    = 0;
+    worldName    = name;
+    revealed.clear();
+
+    allocateBoard( layout.rows, layout.cols );
+    agentX = layout.startX;
+    agentY = layout.startY;
+    for ( int c = 0; c < colDimension; ++c )
+        for ( int r = 0; r < rowDimension; ++r )
+            if ( layout.mines[c * rowDimension + r] )
+            {
+                board[c][r].mine = true;
+                ++totalMines;
+            }
+    addMineCount();
+    lastAction = genFirstAxis( agentX, agentY );
+
+    startGame();
+}
+
+void World::startGame( )
+// Everything reset() does once the board is loaded
+{
+    // computed in 64 bits so very large boards don't overflow the limit
+    maxMoves = (int) min( 2LL * rowDimension * colDimension, (long long) INT_MAX );
 
     switch (colDimension)
     {
@@ -85,23 +163,55 @@ World::World(bool _debug, string aiType, string filename)
     score      = 0;
     coveredTiles = rowDimension * colDimension - 1;
     flagLeft   = totalMines;
-
-    if (aiType == "randomAI")
-        agent = new RandomAI( rowDimension, colDimension, totalMines, agentX, agentY );
-
-    else if (aiType == "manualAI")
-        agent = new ManualAI( rowDimension, colDimension, totalMines, agentX, agentY );
-
+    if ( debug || agentKind == MANUAL_AI )
+        renderer.reset( rowDimension, colDimension );
+
+    if ( agentKind == PLUGIN_AI )
+        options.plugin->reset( agent, rowDimension, colDimension, totalMines, agentX, agentY );
+    else if ( agent && agentKind == MY_AI )
+        static_cast<MyAI*>( agent )->reset( rowDimension, colDimension, totalMines, agentX, agentY );
+    else if ( agent && agentKind == EXTERNAL_AI )
+        // the process stays up; it is only told a new game has started
+        static_cast<ExternalAgent*>( agent )->newGame( rowDimension, colDimension, totalMines, agentX, agentY );
     else
-        agent = new MyAI( rowDimension, colDimension, totalMines, agentX, agentY );
+    {
+        // The other agents hold no buffers worth keeping
+        delete agent;
+        if (agentKind == RANDOM_AI)
+            agent = new RandomAI( rowDimension, colDimension, totalMines, agentX, agentY );
+        else if (agentKind == MANUAL_AI)
+            agent = new ManualAI( rowDimension, colDimension, totalMines, agentX, agentY );
+        else if (agentKind == EXTERNAL_AI)
+            agent = new ExternalAgent( options.agentCommand, rowDimension, colDimension, totalMines, agentX, agentY );
+        else
+            agent = new MyAI( rowDimension, colDimension, totalMines, agentX, agentY );
+    }
 
+    // The first tile is always a zero, so in cascade mode its region is
+    // open before the agent's first move
+    cascading = options.cascade && agent->supportsCascade();
+    if ( cascading && board[agentX][agentY].number == 0 )
+        cascade( agentX, agentY );
 }
 
-World::~World() {
-    for ( int index = 0; index < colDimension; ++index )
-        delete [] board[index];
+void World::allocateBoard( int rows, int cols )
+// All tiles live in one block, column after column, with board[c] pointing
+// at the start of column c. Same-sized boards are cleared in place.
+{
+    if ( tiles == nullptr || rows != rowDimension || cols != colDimension )
+    {
+        delete [] board;
+        delete [] tiles;
+        rowDimension = rows;
+        colDimension = cols;
+        tiles = new Tile[(size_t) rowDimension * colDimension];
+        board = new Tile*[colDimension];
+        for ( int index = 0; index < colDimension; ++index )
+            board[index] = tiles + index * rowDimension;
+        return;
+    }
 
-    delete [] board;
+    fill( tiles, tiles + (size_t) rowDimension * colDimension, Tile() );
 }
 
 // ===============================================================
@@ -109,6 +219,54 @@ World::~World() {
 // ===============================================================
 
 int World::run()
+{
+    ProfileScope profile( PROFILE_GAME );
+
+    // Nothing is printed or read from stdin, so take the headless loop
+    // and let the compiler see the concrete agent type. Only headless
+    // games are timed by the watchdog; the others go at a person's pace.
+    if ( !debug && agentKind != MANUAL_AI )
+    {
+        Watchdog& watchdog = Watchdog::shared();
+        watchdog.beginGame();
+        int result = runHeadlessAgent();
+        watchdog.endGame();
+        // a game the watchdog stopped is forfeited
+        return watchdog.timedOut() ? 0 : result;
+    }
+
+    return runInteractive();
+}
+
+int World::runHeadlessAgent()
+{
+    if ( options.trace )
+        return runRecorded();
+    if ( agentKind == RANDOM_AI )
+        return agent->supportsBatch() ? runHeadlessBatch<RandomAI>() : runHeadless<RandomAI>();
+    if ( agentKind == EXTERNAL_AI )
+        return runHeadlessBatch<ExternalAgent>();
+    if ( agentKind == PLUGIN_AI )
+        return agent->supportsBatch() ? runHeadlessBatch<Agent>() : runHeadless<Agent>();
+    return agent->supportsBatch() ? runHeadlessBatch<MyAI>() : runHeadless<MyAI>();
+}
+
+int World::moves() const
+{
+    return moveCount;
+}
+
+int World::peakFrontier() const
+{
+    return agent ? agent->peakFrontier() : -1;
+}
+
+long long World::searchNodes() const
+{
+    return agent ? agent->searchNodes() : -1;
+}
+
+int World::runInteractive()
 {
     int perceptNumber;
     bool gameOver = false;
@@ -116,27 +274,32 @@ int World::run()
 
     while ( !gameOver && move < maxMoves )
     {
-        if ( debug || dynamic_cast<ManualAI*>(agent))
-        {
-            printWorldInfo();
+        printWorldInfo();
 
-            if ( !dynamic_cast<ManualAI*>(agent) )
-            {
-                // Pause the game, only if manualAI isn't on
-                // because manualAI pauses for us
-                cout << "Press ENTER to continue..." << endl;
-                cin.ignore( 999, '\n');
-            }
+        if ( options.watch )
+        {
+            if ( options.watchDelay > 0 )
+                this_thread::sleep_for( chrono::milliseconds( options.watchDelay ) );
+        }
+        else if ( agentKind != MANUAL_AI )
+        {
+            // Pause the game, only if manualAI isn't on
+            // because manualAI pauses for us
+            cout << "Press ENTER to continue..." << endl;
+            cin.ignore( 999, '\n');
         }
 
         if (lastAction.action == Agent::UNCOVER)
             perceptNumber = board[agentX][agentY].number;
         else
             perceptNumber = -1;
+        deliverRevealed( agent );
         lastAction = agent->getAction( perceptNumber );
 
         // Make the move
         gameOver = doMove();
+        if ( gameOver )
+            printWorldInfo();
 
         move++;
     }
@@ -144,6 +307,117 @@ int World::run()
     return score;
 }
 
+template <class AgentT>
+int World::runHeadless()
+// Same rules as runInteractive, but with no printing or pausing and a
+// direct (devirtualized) call into the final agent class every move.
+{
+    AgentT* concreteAgent = static_cast<AgentT*>( agent );
+    Watchdog& watchdog = Watchdog::shared();
+    bool gameOver = false;
+
+    for ( int move = 0; !gameOver && move < maxMoves; ++move )
+    {
+        int perceptNumber = lastAction.action == Agent::UNCOVER ? board[agentX][agentY].number : -1;
+        watchdog.beginTurn();
+        deliverRevealed( concreteAgent );
+        lastAction = concreteAgent->getAction( perceptNumber );
+        watchdog.endTurn();
+        if ( Watchdog::cancelled() )
+            break;
+        gameOver = doMove();
+    }
+
+    return score;
+}
+
+template <class AgentT>
+int World::runHeadlessBatch()
+// Headless loop over the batch interface. Every action counts as a move
+// against maxMoves, exactly as in runHeadless.
+{
+    AgentT* concreteAgent = static_cast<AgentT*>( agent );
+    Watchdog& watchdog = Watchdog::shared();
+    bool gameOver = false;
+    int move = 0;
+
+    percepts.assign( 1, lastAction.action == Agent::UNCOVER ? board[agentX][agentY].number : -1 );
+    while ( !gameOver && move < maxMoves )
+    {
+        actions.clear();
+        watchdog.beginTurn();
+        deliverRevealed( concreteAgent );
+        concreteAgent->getActions( percepts, actions );
+        watchdog.endTurn();
+        if ( actions.empty() || Watchdog::cancelled() )
+            break;
+
+        percepts.clear();
+        for ( const Agent::Action& action : actions )
+        {
+            lastAction = action;
+            gameOver = doMove();
+            if ( gameOver || ++move >= maxMoves )
+                break;
+            percepts.push_back( lastAction.action == Agent::UNCOVER ? board[agentX][agentY].number : -1 );
+        }
+    }
+
+    return score;
+}
+
+int World::runRecorded()
+// runHeadless through the plain Agent interface, timing every agent turn
+// and writing the game to options.trace when it ends
+{
+    recording.clear();
+    recording.world  = worldName;
+    recording.seed   = worldName.empty() ? worldSeed : 0;
+    recording.rows   = rowDimension;
+    recording.cols   = colDimension;
+    recording.mines  = totalMines;
+    recording.startX = agentX;
+    recording.startY = agentY;
+
+    Watchdog& watchdog = Watchdog::shared();
+    bool gameOver = false;
+    for ( int move = 0; !gameOver && move < maxMoves; ++move )
+    {
+        TraceMove traced;
+        traced.percept = lastAction.action == Agent::UNCOVER ? board[agentX][agentY].number : -1;
+        traced.reveals = (int) revealed.size();
+        recording.reveals.insert( recording.reveals.end(), revealed.begin(), revealed.end() );
+
+        auto start = chrono::steady_clock::now();
+        watchdog.beginTurn();
+        deliverRevealed( agent );
+        lastAction = agent->getAction( traced.percept );
+        watchdog.endTurn();
+        traced.nanos = chrono::duration_cast<chrono::nanoseconds>( chrono::steady_clock::now() - start ).count();
+        if ( Watchdog::cancelled() )
+            break;
+
+        traced.action = lastAction;
+        recording.moves.push_back( traced );
+        gameOver = doMove();
+    }
+
+    recording.score = Watchdog::cancelled() ? 0 : score;
+    options.trace->write( recording );
+    return score;
+}
+
+template <class AgentT>
+void World::deliverRevealed( AgentT* target )
+// Hands the tiles uncovered by cascades since the agent's last turn to
+// the agent in one call
+{
+    if ( revealed.empty() )
+        return;
+    target->revealed( revealed );
+    revealed.clear();
+}
+
 
 // ===============================================================
 // =				World Generation Functions
@@ -268,12 +542,11 @@ void World::uncoverAll()
         for ( int r = 0; r < rowDimension; ++r )
             board[c][r].uncovered = true;
     }
-    if ( debug || dynamic_cast<ManualAI*>(agent) )
-        printWorldInfo();
 }
 
 bool World::doMove()
 {
+    ++moveCount;
     agentX       = lastAction.x;
     agentY       = lastAction.y;
 
@@ -295,6 +568,8 @@ bool World::doMove()
             {
                 board[agentX][agentY].uncovered = true;
                 --coveredTiles;
+                if ( cascading && board[agentX][agentY].number == 0 )
+                    cascade( agentX, agentY );
             }
 
             break;
@@ -325,6 +600,41 @@ bool World::doMove()
     return false;
 }
 
+void World::cascade( int c, int r )
+// Uncovers every tile reachable from the zero at (c, r) through zeros, and
+// queues them in 'revealed'. The fill is iterative over tile indexes into
+// the column-major tile block, and scans each neighborhood column by
+// column so consecutive reads stay within a column's contiguous run.
+// Flagged tiles are left for the agent to deal with.
+{
+    fillStack.assign( 1, c * rowDimension + r );
+    while ( !fillStack.empty() )
+    {
+        int index = fillStack.back();
+        fillStack.pop_back();
+        int tc = index / rowDimension;
+        int tr = index % rowDimension;
+
+        int lastCol = min( tc + 1, colDimension - 1 );
+        int lastRow = min( tr + 1, rowDimension - 1 );
+        for ( int nc = max( tc - 1, 0 ); nc <= lastCol; ++nc )
+        {
+            Tile* column = board[nc];
+            for ( int nr = max( tr - 1, 0 ); nr <= lastRow; ++nr )
+            {
+                Tile& tile = column[nr];
+                if ( tile.uncovered || tile.flag )
+                    continue;
+                tile.uncovered = true;
+                --coveredTiles;
+                revealed.push_back( {nc, nr, tile.number} );
+                if ( tile.number == 0 )
+                    fillStack.push_back( nc * rowDimension + nr );
+            }
+        }
+    }
+}
+
 bool World::isInBounds ( int c, int r )
 {
     return ( 0 <= c && c < colDimension && 0 <= r && r < rowDimension );
@@ -335,85 +645,59 @@ bool World::isInBounds ( int c, int r )
 // ===============================================================
 
 void World::printWorldInfo(     )
+// Draws the board and percepts as one frame; see BoardRenderer
 {
-    printBoardInfo();
-    printAgentInfo();
-}
-
-void World::printBoardInfo(     )
-{
-    cout << "---------------- Game Board ------------------\n" << endl;
-    for ( int r = rowDimension-1; r >= 0; --r )
-    {
-        printf("%-4d%c",r+1,'|');
-        for ( int c = 0; c < colDimension; ++c )
-            printTileInfo ( c, r );
-        cout << endl << endl;
-    }
+    for ( int c = 0; c < colDimension; ++c )
+        for ( int r = 0; r < rowDimension; ++r )
+            renderer.set( c, r, tileGlyph( c, r ) );
 
-    cout << "     ";
-    for (int c = 0; c < colDimension; ++c)
-        cout << setw(8) << "-" ;
-    cout << endl << "     ";
-    for (int c = 0; c < colDimension; ++c)
-        cout << setw(8) << c + 1;
-    cout << endl;
+    status.str( "" );
+    printAgentInfo( status );
+    renderer.render( status.str(), cout );
 }
 
-void World::printTileInfo( int c, int r )
+char World::tileGlyph( int c, int r )
 {
-
-    string tileString;
-
     if ( board[c][r].uncovered )
-        if ( board[c][r].mine )
-            tileString.append("*");
-        else
-        {
-            tileString.append(to_string(board[c][r].number));
-
-        }
-    else if ( board[c][r].flag )
-            tileString.append("#");
-    else
-        tileString.append(".");
-
-    cout << setw(8) << tileString;
+        return board[c][r].mine ? '*' : '0' + board[c][r].number;
+    if ( board[c][r].flag )
+        return '#';
+    return '.';
 }
 
-void World::printAgentInfo()
+void World::printAgentInfo( ostream& out )
 {
-    cout << "\n------------------ Percepts ------------------ " << endl;
-    cout << "Tiles Covered: " << coveredTiles;
-    cout << " Flags Left: " << flagLeft << "    ";
+    out << "\n------------------ Percepts ------------------ " << "\n";
+    out << "Tiles Covered: " << coveredTiles;
+    out << " Flags Left: " << flagLeft << "    ";
 
 
-    printActionInfo ();
+    printActionInfo ( out );
 }
 
-void World::printActionInfo()
+void World::printActionInfo( ostream& out )
 {
     switch ( lastAction.action )
     {
         case Agent::UNCOVER:
-            cout << "Last Action: Uncover";
+            out << "Last Action: Uncover";
             break;
         case Agent::FLAG:
-            cout << "Last Action: Flag";
+            out << "Last Action: Flag";
             break;
         case Agent::UNFLAG:
-            cout << "Last Action: Unflag";
+            out << "Last Action: Unflag";
             break;
         case Agent::LEAVE:
-            cout << "Last Action: Leave" << endl;
+            out << "Last Action: Leave" << "\n";
             break;
 
         default:
-            cout << "Last Action: Invalid" << endl;
+            out << "Last Action: Invalid" << "\n";
     }
 
     if (lastAction.action != Agent::LEAVE)
-        cout << " on tile " << agentX + 1 << " " << agentY + 1 << endl;
+        out << " on tile " << agentX + 1 << " " << agentY + 1 << "\n";
 }
 
 // ===============================================================
@@ -433,3 +717,31 @@ int World::randomInt ( int limit )
 
 
 
+
+// ===============================================================
+// =					World Layout
+// ===============================================================
+
+bool WorldLayout::load( const string& filename )
+// Reads the same format reset() does: dimensions, the 1-based start, then
+// the rows top first
+{
+    ifstream file( filename );
+    file >> rows >> cols >> startX >> startY;
+    if ( file.fail() || rows <= 0 || cols <= 0 )
+        return false;
+    --startX;
+    --startY;
+
+    mines.assign( (size_t) rows * cols, 0 );
+    for ( int r = rows - 1; r >= 0; --r )
+        for ( int c = 0; c < cols; ++c )
+        {
+            int mine;
+            file >> mine;
+            if ( file.fail() )
+                return false;
+            mines[(size_t) c * rows + r] = mine != 0;
+        }
+    return true;
+}
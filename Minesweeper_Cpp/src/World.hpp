@@ -18,51 +18,110 @@
 #include <iomanip>      // setw
 #include <string>       // string
 #include <fstream>      // file
+#include <algorithm>    // fill, min
+#include <climits>      // INT_MAX
+#include <chrono>       // steady_clock
+#include <sstream>      // ostringstream
+#include <thread>       // sleep_for
 #include "Agent.hpp"
 #include "ManualAI.hpp"
 #include "RandomAI.hpp"
 #include "MyAI.hpp"
+#include "ExternalAgent.hpp"
+#include "AgentPlugin.hpp"
+#include "GameTrace.hpp"
+#include "BoardRenderer.hpp"
+#include "Profiler.hpp"
+#include "Watchdog.hpp"
+
+// Optional engine behavior, off by default so the classic rules apply
+struct WorldOptions{
+    bool cascade = false;   // uncovering a zero uncovers its whole region in one move
+    string agentCommand;    // if set, play through an external agent run by this command
+    TraceWriter* trace = nullptr;   // if set, every game played headless is recorded here
+    bool watch = false;     // show the board every move, like debug, without waiting for ENTER
+    int watchDelay = 0;     // milliseconds to pause after each frame in watch mode
+    const AgentPlugin* plugin = nullptr;    // if set, play through an agent loaded from this plugin
+};
+
+// A world file, read once so that several worlds can be reset from it
+// without reading the file again
+struct WorldLayout{
+    int rows = 0;
+    int cols = 0;
+    int startX = 0;             // 0-based
+    int startY = 0;
+    std::vector<char> mines;    // indexed [col * rows + row]
+    bool load ( const string& filename );   // false if the file is missing or malformed
+};
 
 class World{
 
 public:
-    World(bool debug, string aiType, string filename);      // Constructor
+    World(bool debug, string aiType, string filename,
+          WorldOptions options = WorldOptions());           // Constructor
+    World(bool debug, string aiType, const WorldLayout& layout, string name,
+          WorldOptions options = WorldOptions());           // The same, from a world already read
     ~World  (  );                                           // Destructor
+    void reset ( string filename );                         // Load another world, reusing buffers
+    void reset ( const WorldLayout& layout, string name );  // The same, from a world already read
     int run (  );                                           // Engine function
+    int moves (  ) const;                                   // Actions applied in the current game
+    int peakFrontier (  ) const;                            // The agent's peakFrontier(), or -1
+    long long searchNodes (  ) const;                       // The agent's searchNodes(), or -1
 
 private:
+    // Concrete agent selected by aiType, used to pick the headless loop
+    enum AgentKind{
+        MY_AI,
+        RANDOM_AI,
+        MANUAL_AI,
+        EXTERNAL_AI,
+        PLUGIN_AI,
+    };
+
     // Tile structure
     struct Tile{
         bool mine       = false; // the tile has Bomb or not
         bool uncovered  = false; // the tile uncovered or not
         bool flag       = false; // the tile has been flag or not
-        int  number     = 0;     // records number of bombs around
+        unsigned char number = 0; // records number of bombs around (one byte keeps large boards compact)
     };
 
     // Operation Variables
     bool 	debug;			    // If true, displays board info after every move
+    AgentKind   agentKind;          // Which concrete agent 'agent' points to
+    WorldOptions options;           // Optional engine behavior
+    bool        cascading = false;  // options.cascade, and the agent supports it
 
     // Agent Variables
-    Agent* 	agent;			    // The agent
+    Agent* 	agent = nullptr;	// The agent, owned by the world
     int 	score;			    // The agent's score
     int     flagLeft;           // flag remaining
     int	    agentX;			    // The column where the agent is located ( x-coord = col-coord )
     int	    agentY;			    // The row where the agent is located ( y-coord = row-coord )
     int     coveredTiles;       // For faster score calculation and
     int     correctFlags = 0;   // checking game-terminating conditions.
+    int     moveCount = 0;      // Actions applied by doMove this game
     Agent::Action	lastAction;	// The last action the agent made
 
     // Board Variables
-    int	    colDimension;	    // The number of columns the game board has
-    int	    rowDimension;	    // The number of rows the game board has
-    Tile**	board;			    // The game board
+    int	    colDimension = 0;	// The number of columns the game board has
+    int	    rowDimension = 0;	// The number of rows the game board has
+    Tile**	board = nullptr;	// The game board, indexed [col][row]
+    Tile*   tiles = nullptr;    // Storage for all tiles of the board
     int     totalMines = 0;         // Number of mines the game board has
+    string  worldName;              // The world file, or empty for a random world
+    unsigned worldSeed = 0;         // The seed a random world was generated from
 
     // World Variables
     int maxMoves;               // the limit of how many actions
     int Bonus;                  // Bonus based on difficulty
 
     // World Management functions
+    void            chooseAgent     ( bool debug, string aiType, WorldOptions options );  // options and agent kind, before the first reset
+    void            startGame       (   );                  // scoring, limits and agent for the loaded board
+    void            allocateBoard   ( int rows, int cols ); // size the board, reusing the same-sized one
     void 	        addFeatures	    (   );                  // add random features to the board
     void	        addFeatures ( std::ifstream &file );	// add specified features according the file to the board
     Agent::Action   genFirstAxis    (   );                  // generate first move axis for default board
@@ -72,14 +131,39 @@ private:
     void            addNeighbour    ( int c, int r );       // helper function for addMineCount
     void            uncoverAll      (   );                  // reveal all the tile at the end
     bool            doMove          (   );                  // apply agent's action to the board
+    void            cascade         ( int c, int r );       // uncover the zero region around a zero tile
+    template <class AgentT>
+    void            deliverRevealed ( AgentT* target );     // hand cascaded tiles to the agent
     bool            isInBounds      ( int c, int r );       // check bound
 
+    // Engine functions
+    int             runInteractive  (   );                  // game loop with printing and pausing
+    int             runHeadlessAgent(   );                  // the headless loop for the agent kind
+    template <class AgentT>
+    int             runHeadless     (   );                  // game loop specialized on the agent type
+    template <class AgentT>
+    int             runHeadlessBatch(   );                  // the same, through the batch interface
+    int             runRecorded     (   );                  // headless loop that records a trace
+
+    // Batch interface buffers, reused between moves
+    std::vector<int>            percepts;
+    std::vector<Agent::Action>  actions;
+
+    // Cascade mode buffers: tiles uncovered by the fill and not yet given
+    // to the agent, and the fill's work stack of tile indexes
+    std::vector<Agent::Reveal>  revealed;
+    std::vector<int>            fillStack;
+
+    // The game being recorded when options.trace is set
+    GameTrace                   recording;
+
     // World printing functions
+    BoardRenderer   renderer;           // draws the board in debug and manual modes
+    ostringstream   status;             // text under the board, rebuilt every frame
     void	        printWorldInfo	(   );
-    void            printBoardInfo  (   );
-    void            printTileInfo   ( int c, int r );
-    void	        printAgentInfo  (   );
-    void	        printActionInfo	(   );
+    char            tileGlyph       ( int c, int r );
+    void	        printAgentInfo  ( ostream& out );
+    void	        printActionInfo	( ostream& out );
 
     // Helper Functions
     int	            randomInt	( int limit );              // Randomly generate a int in the range [0, limit)
@@ -34,6 +34,12 @@ public class MyAI extends AI {
 	//
 	// ###################### END OF INSTURCTIONS #######################
 	
+	// The C++ MyAI, through the native solver library when it is built
+	// ('make solverlib' in Minesweeper_Cpp); without it, LEAVE at once.
+	// One native agent plays every game, reset for each, so its buffers
+	// are allocated once per run.
+	private static NativeSolver.Agent nativeAgent;
+
 	// This line is to remove compiler warnings related to using Java generics
 	// if you decide to do so in your implementation.
 	@SuppressWarnings("unchecked")
@@ -41,11 +47,16 @@ public class MyAI extends AI {
 
 	public MyAI(int rowDimension, int colDimension, int totalMines, int startX, int startY) {
 		// ################### Implement Constructor (required) ####################	
+		if (nativeAgent != null)
+			nativeAgent.newGame(rowDimension, colDimension, totalMines, startX, startY);
+		else if (NativeSolver.available())
+			nativeAgent = new NativeSolver.Agent(rowDimension, colDimension, totalMines, startX, startY);
 	}
 	
 	// ################## Implement getAction(), (required) #####################
 	public Action getAction(int number) {
-
+		if (nativeAgent != null)
+			return nativeAgent.getAction(number);
 		return new Action(ACTION.LEAVE);
 	}
 
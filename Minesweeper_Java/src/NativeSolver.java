@@ -0,0 +1,123 @@
+/*
+
+DESCRIPTION: This file binds the native solver library of the C++ shell
+             (Minesweeper_Cpp/src/SolverLib.hpp) through JNI, so an agent
+             here can use MyAI's solver at native speed.
+
+NOTES:       - Build the library with 'make solverlib' in Minesweeper_Cpp,
+               with JAVA_HOME set so it includes the JNI methods. It is
+               loaded from the path in the MINESWEEPER_SOLVER environment
+               variable, then from ../Minesweeper_Cpp/bin/libminesolver.so
+               (run from Minesweeper_Java), then from java.library.path.
+
+             - Agent is MyAI: construct it like an agent of this shell and
+               call getAction. solve() gives the chance every square of a
+               position is a mine.
+
+             - Coordinates are this shell's, 1-based; the library's are
+               0-based with the same orientation, so they are shifted by
+               one each way. Boards are indexed board[x - 1][y - 1] and
+               hold COVERED, FLAGGED or the number uncovered.
+*/
+
+package src;
+
+import java.io.File;
+import src.Action.ACTION;
+
+public class NativeSolver {
+	public static final int ABI = 1;
+	public static final int COVERED = -1;
+	public static final int FLAGGED = -2;
+
+	private static Boolean loaded = null;
+
+	// True once the library is loaded and of the ABI this class was written for
+	public static synchronized boolean available() {
+		if (loaded == null) {
+			loaded = load();
+		}
+		return loaded;
+	}
+
+	private static boolean load() {
+		try {
+			String path = System.getenv("MINESWEEPER_SOLVER");
+			File local = new File("../Minesweeper_Cpp/bin/libminesolver.so");
+			if (path != null) {
+				System.load(new File(path).getAbsolutePath());
+			} else if (local.exists()) {
+				System.load(local.getAbsolutePath());
+			} else {
+				System.loadLibrary("minesolver");
+			}
+			return abi() == ABI;
+		} catch (UnsatisfiedLinkError e) {
+			return false;
+		}
+	}
+
+	private static native int abi();
+	private static native void configure(String name, String value);
+	private static native long create(int rows, int cols, int mines, int startX, int startY);
+	private static native boolean reset(long agent, int rows, int cols, int mines, int startX, int startY);
+	private static native void destroy(long agent);
+	private static native int getAction(long agent, int number, int[] xy);
+	private static native int solve(int rows, int cols, int mines, int[] squares, double[] mineProbability);
+
+	// Passes a long option of the C++ shell, e.g. setOption("patterns", path)
+	public static void setOption(String name, String value) {
+		configure(name, value);
+	}
+
+	// The chance each square is a mine, indexed like board, or null if no
+	// placement of mines fits the numbers
+	public static double[][] solve(int[][] board, int totalMines) {
+		int cols = board.length, rows = board[0].length;
+		int[] squares = new int[rows * cols];
+		for (int x = 0; x < cols; ++x)
+			for (int y = 0; y < rows; ++y)
+				squares[y * cols + x] = board[x][y];
+		double[] chances = new double[rows * cols];
+		if (solve(rows, cols, totalMines, squares, chances) < 0)
+			return null;
+		double[][] result = new double[cols][rows];
+		for (int x = 0; x < cols; ++x)
+			for (int y = 0; y < rows; ++y)
+				result[x][y] = chances[y * cols + x];
+		return result;
+	}
+
+	public static class Agent extends AI {
+		private static final ACTION[] ACTIONS = ACTION.values();
+		private long agent;
+		private final int[] xy = new int[2];
+
+		public Agent(int rowDimension, int colDimension, int totalMines, int startX, int startY) {
+			agent = create(rowDimension, colDimension, totalMines, startX - 1, startY - 1);
+			if (agent == 0)
+				throw new IllegalArgumentException("invalid board for the native solver");
+		}
+
+		// Starts a new game with the same native agent
+		public void newGame(int rowDimension, int colDimension, int totalMines, int startX, int startY) {
+			if (!reset(agent, rowDimension, colDimension, totalMines, startX - 1, startY - 1))
+				throw new IllegalArgumentException("invalid board for the native solver");
+		}
+
+		// Frees the native agent; the agent can't be used afterwards
+		public void close() {
+			if (agent != 0) {
+				destroy(agent);
+				agent = 0;
+			}
+		}
+
+		public Action getAction(int number) {
+			ACTION action = ACTIONS[NativeSolver.getAction(agent, number, xy)];
+			if (action == ACTION.LEAVE)
+				return new Action(ACTION.LEAVE);
+			return new Action(action, xy[0] + 1, xy[1] + 1);
+		}
+	}
+}
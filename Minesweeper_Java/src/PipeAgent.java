@@ -0,0 +1,79 @@
+/*
+
+DESCRIPTION: This file serves an agent from this shell to the C++ World
+             over the binary pipe protocol described in
+             Minesweeper_Cpp/src/ExternalAgent.hpp. One JVM plays every
+             game of a run, so there is no startup cost per game.
+
+NOTES:       - Syntax (from the C++ shell):
+
+                 Minesweeper -f [InputPath] --agent="java -cp bin/mine.jar src.PipeAgent"
+
+               Add -r to serve RandomAI instead of MyAI.
+
+             - The protocol uses 0-based coordinates with row 0 at the
+               bottom; this shell's agents use the same layout 1-based,
+               so coordinates are shifted by one each way.
+
+             - System.out carries the protocol, so anything the agent
+               prints is sent to System.err instead.
+*/
+
+package src;
+
+import java.io.*;
+
+public class PipeAgent {
+	private static final int FRAME_GAME = 1;
+	private static final int FRAME_TURN = 2;
+
+	public static void main(String[] args) throws IOException {
+		boolean random = args.length > 0 && args[0].equals("-r");
+		DataInputStream requests = new DataInputStream(new BufferedInputStream(System.in));
+		DataOutputStream replies = new DataOutputStream(new BufferedOutputStream(new FileOutputStream(FileDescriptor.out)));
+		System.setOut(System.err);
+
+		AI agent = null;
+		while (true) {
+			int frame;
+			try {
+				frame = readInt(requests);
+			} catch (EOFException e) {
+				break;
+			}
+
+			if (frame == FRAME_GAME) {
+				int rows = readInt(requests);
+				int cols = readInt(requests);
+				int mines = readInt(requests);
+				int startX = readInt(requests);
+				int startY = readInt(requests);
+				agent = random ? new RandomAI(rows, cols, mines)
+				               : new MyAI(rows, cols, mines, startX + 1, startY + 1);
+				continue;
+			}
+
+			// only the last percept matters to a one-action-per-turn agent
+			int count = readInt(requests);
+			int number = -1;
+			for (int i = 0; i < count; ++i)
+				number = readInt(requests);
+
+			Action action = agent.getAction(number);
+			writeInt(replies, 1);
+			writeInt(replies, action.action.ordinal());
+			writeInt(replies, action.x - 1);
+			writeInt(replies, action.y - 1);
+			replies.flush();
+		}
+	}
+
+	// DataInput is big-endian; the protocol is little-endian
+	private static int readInt(DataInputStream in) throws IOException {
+		return Integer.reverseBytes(in.readInt());
+	}
+
+	private static void writeInt(DataOutputStream out, int value) throws IOException {
+		out.writeInt(Integer.reverseBytes(value));
+	}
+}
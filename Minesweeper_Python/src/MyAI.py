@@ -14,6 +14,7 @@
 
 from AI import AI
 from Action import Action
+import NativeSolver
 
 
 class MyAI( AI ):
@@ -23,7 +24,11 @@ class MyAI( AI ):
 		########################################################################
 		#							YOUR CODE BEGINS						   #
 		########################################################################
-		pass
+		# The C++ MyAI, through the native solver library when it is built
+		# ('make solverlib' in Minesweeper_Cpp); without it, LEAVE at once
+		self.__native = None
+		if NativeSolver.available():
+			self.__native = NativeSolver.NativeAgent(rowDimension, colDimension, totalMines, startX, startY)
 		########################################################################
 		#							YOUR CODE ENDS							   #
 		########################################################################
@@ -34,6 +39,8 @@ class MyAI( AI ):
 		########################################################################
 		#							YOUR CODE BEGINS						   #
 		########################################################################
+		if self.__native:
+			return self.__native.getAction(number)
 		return Action(AI.Action.LEAVE)
 		########################################################################
 		#							YOUR CODE ENDS							   #
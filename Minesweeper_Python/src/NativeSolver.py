@@ -0,0 +1,102 @@
+# ==============================CS-199==================================
+# FILE:			NativeSolver.py
+#
+# DESCRIPTION:	This file binds the native solver library of the C++
+#				shell (Minesweeper_Cpp/src/SolverLib.hpp) through ctypes,
+#				so an agent here can use MyAI's solver at native speed.
+#
+# NOTES: 		- Build the library with 'make solverlib' in
+#				  Minesweeper_Cpp. It is looked for at the path in the
+#				  MINESWEEPER_SOLVER environment variable, then at
+#				  Minesweeper_Cpp/bin/libminesolver.so next to this shell.
+#
+#				- NativeAgent is MyAI: construct it like an agent of this
+#				  shell and call getAction. solve() gives the chance every
+#				  square of a position is a mine.
+#
+#				- Coordinates are this shell's: 0-based, row 0 at the
+#				  bottom, the same as the library's. Boards are lists of
+#				  rows, board[y][x], holding COVERED, FLAGGED or the
+#				  number uncovered.
+# ==============================CS-199==================================
+
+import ctypes
+import os
+from AI import AI
+from Action import Action
+
+ABI = 1
+COVERED = -1
+FLAGGED = -2
+
+__library = None
+
+
+def library() -> "ctypes.CDLL or None":
+	""" The loaded library, or None if it can't be found or is another ABI """
+	global __library
+	if __library is None:
+		here = os.path.dirname(os.path.abspath(__file__))
+		path = os.environ.get("MINESWEEPER_SOLVER",
+			os.path.join(here, "..", "..", "Minesweeper_Cpp", "bin", "libminesolver.so"))
+		try:
+			lib = ctypes.CDLL(path)
+		except OSError:
+			__library = False
+			return None
+		lib.ms_solver_abi.restype = ctypes.c_int
+		lib.ms_solver_configure.argtypes = [ctypes.c_char_p, ctypes.c_char_p]
+		lib.ms_agent_create.restype = ctypes.c_void_p
+		lib.ms_agent_create.argtypes = [ctypes.c_int] * 5
+		lib.ms_agent_reset.argtypes = [ctypes.c_void_p] + [ctypes.c_int] * 5
+		lib.ms_agent_destroy.argtypes = [ctypes.c_void_p]
+		lib.ms_agent_get_action.argtypes = [ctypes.c_void_p, ctypes.c_int,
+			ctypes.POINTER(ctypes.c_int), ctypes.POINTER(ctypes.c_int)]
+		lib.ms_solve.argtypes = [ctypes.c_int, ctypes.c_int, ctypes.c_int,
+			ctypes.POINTER(ctypes.c_int), ctypes.POINTER(ctypes.c_double)]
+		__library = lib if lib.ms_solver_abi() == ABI else False
+	return __library or None
+
+
+def available() -> bool:
+	return library() is not None
+
+
+def configure(name: str, value: str = "") -> None:
+	""" Pass a long option of the C++ shell, e.g. configure("patterns", path) """
+	library().ms_solver_configure(name.encode(), value.encode())
+
+
+def solve(board: list, totalMines: int) -> "list or None":
+	""" The chance each square is a mine, board[y][x] style, or None if no
+		placement of mines fits the numbers """
+	rows, cols = len(board), len(board[0])
+	squares = (ctypes.c_int * (rows * cols))(*[square for row in board for square in row])
+	chances = (ctypes.c_double * (rows * cols))()
+	if library().ms_solve(rows, cols, totalMines, squares, chances) < 0:
+		return None
+	return [list(chances[y * cols:(y + 1) * cols]) for y in range(rows)]
+
+
+class NativeAgent( AI ):
+
+	def __init__(self, rowDimension, colDimension, totalMines, startX, startY):
+		self.__lib = library()
+		self.__agent = self.__lib.ms_agent_create(rowDimension, colDimension, totalMines, startX, startY)
+		if not self.__agent:
+			raise ValueError("invalid board for the native solver")
+		self.__x = ctypes.c_int()
+		self.__y = ctypes.c_int()
+
+
+	def __del__(self):
+		if getattr(self, "_NativeAgent__agent", None):
+			self.__lib.ms_agent_destroy(self.__agent)
+
+
+	def getAction(self, number: int) -> "Action Object":
+		action = self.__lib.ms_agent_get_action(self.__agent, number,
+			ctypes.byref(self.__x), ctypes.byref(self.__y))
+		if AI.Action(action) == AI.Action.LEAVE:
+			return Action(AI.Action.LEAVE)     # MyAI leaves its square undefined
+		return Action(AI.Action(action), self.__x.value, self.__y.value)
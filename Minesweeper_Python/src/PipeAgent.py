@@ -0,0 +1,78 @@
+# ==============================CS-199==================================
+# FILE:			PipeAgent.py
+#
+# DESCRIPTION:	This file serves an agent from this shell to the C++
+#				World over the binary pipe protocol described in
+#				Minesweeper_Cpp/src/ExternalAgent.hpp. One process plays
+#				every game of a run, so there is no startup cost per game.
+#
+# NOTES: 		- Syntax (from the C++ shell):
+#
+#					Minesweeper -f [InputPath] --agent="python3 PipeAgent.py"
+#
+#				  Add -r after PipeAgent.py to serve RandomAI instead of
+#				  MyAI.
+#
+#				- An agent with a getActions(percepts) method, returning
+#				  a list of Actions, is given every percept of its last
+#				  batch and may answer with several actions at once.
+#				  Other agents are called through getAction.
+#
+#				- stdout carries the protocol, so anything the agent
+#				  prints is sent to stderr instead.
+# ==============================CS-199==================================
+
+import sys
+import struct
+from MyAI import MyAI
+from RandomAI import RandomAI
+
+FRAME_GAME = 1
+FRAME_TURN = 2
+
+
+def readInts(stream, count):
+	""" Read count little-endian int32s, or None at end of input """
+	data = stream.read(4 * count)
+	if len(data) < 4 * count:
+		return None
+	return struct.unpack("<%di" % count, data)
+
+
+def answer(agent, percepts) -> list:
+	""" The agent's actions for one TURN frame """
+	if hasattr(agent, "getActions"):
+		return agent.getActions(list(percepts))
+	return [agent.getAction(percepts[-1] if percepts else -1)]
+
+
+def main():
+	agentClass = RandomAI if "-r" in sys.argv[1:] else MyAI
+	requests = sys.stdin.buffer
+	replies = sys.stdout.buffer
+	sys.stdout = sys.stderr
+
+	agent = None
+	while True:
+		frame = readInts(requests, 1)
+		if frame is None:
+			return
+
+		if frame[0] == FRAME_GAME:
+			rows, cols, mines, startX, startY = readInts(requests, 5)
+			agent = agentClass(rows, cols, mines, startX, startY)
+			continue
+
+		count = readInts(requests, 1)[0]
+		percepts = readInts(requests, count)
+		actions = answer(agent, percepts)
+
+		frame = [len(actions)]
+		for action in actions:
+			frame += [action.getMove().value, action.getX(), action.getY()]
+		replies.write(struct.pack("<%di" % len(frame), *frame))
+		replies.flush()
+
+
+if __name__ == "__main__":
+	main()
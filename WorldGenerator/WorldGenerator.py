@@ -64,13 +64,14 @@ def createWorldFile(filename: "string", rowDimension: int, colDimension: int, nu
 			startingPatch.append((startX+coord[0], startY+coord[1]))
 	
 	# Randomly place mines that aren't in startingPatch
-	mineCoords = []
+	# (a set keeps the membership checks fast on large boards)
+	mineCoords = set()
 	currentMines = 0
 	while currentMines < nMines:
 		x = __randomInt(nCols+1)
 		y = __randomInt(nRows+1)
 		if (x, y) not in startingPatch and (x, y) not in mineCoords:
-			mineCoords.append((x, y))
+			mineCoords.add((x, y))
 			currentMines += 1
 
 	# Open file for writing